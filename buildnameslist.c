@@ -7,11 +7,32 @@
 #include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef HAVE_GETRUSAGE
+#include <sys/resource.h>
+#endif
 
 #include "buildnameslist.h"
 
 #define UNUSED_PARAMETER(x) ((void)x)
 #define BBUFFSIZE 2000
+#define OBUFFSIZE (1<<20)
+
+/* French and English are read, then dumped, each on their own thread */
+/* if there are threads. State used while dumping is kept per thread. */
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#if defined(_MSC_VER)
+#define PERTHREAD __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define PERTHREAD __thread
+#else
+#define PERTHREAD _Thread_local
+#endif
+#else
+#define PERTHREAD
+#endif
 
 /* Build this program using: make buildnameslist		      */
 
@@ -26,15 +47,22 @@ static char *uniannot[2][17*65536];
 /* There are approximately 25 names that changed (version 1 ->2), and */
 /* a few more errors later. names2pt points to the name (after the %) */
 /* and names2ln is the string length of the name if you only want the */
-/* 2nd name without trailing annotations:			      */
+/* 2nd name without trailing annotations, both are 0 if there is none: */
 static char names2pt[2][17*65536];
 static char names2ln[2][17*65536];
-static char names2cnt[2];
+static int names2cnt[2];
 
 static struct block { long int start, end; char *name; struct block *next;}
 	*head[2]={NULL,NULL}, *final[2]={NULL,NULL};
 
-unsigned max_a, max_n;
+static unsigned int maxname[2], maxannot[2];
+
+/* Some names are not listed, but are made from the unicode value. They */
+/* are given as a range, "XXXX\t<label, First>" to "XXXX\t<label, Last>": */
+/* 0=HANGUL SYLLABLE (jamo), 1=CJK UNIFIED IDEOGRAPH-XXXX, 2=TANGUT IDEOGRAPH-XXXX */
+static const char *rangelabel[3] = { "Hangul Syllable", "CJK Ideograph", "Tangut Ideograph" };
+static struct namerange { long int start, end, kind; } ranges[2][32];
+static int rangecnt[2];
 
 static const char *lg[2] = { "", "FR" };
 static const char *lgb[2] = { "UNICODE_EN_BLOCK_MAX", "UNICODE_FR_BLOCK_MAX" };
@@ -111,6 +139,30 @@ static int printcopyright1(FILE *out, int is_fr) {
     return( 1 );
 }
 
+static void readrange(int is_fr, long a_char, const char *label) {
+    static long first[2] = { -1, -1 };
+    size_t len;
+    int k;
+
+    if ( strstr(label,", First>")!=NULL ) {
+	first[is_fr] = a_char;
+return;
+    }
+    if ( strstr(label,", Last>")==NULL || first[is_fr]<0 || first[is_fr]>a_char )
+return;
+    for ( k=0; k<3; ++k ) {
+	len = strlen(rangelabel[k]);
+	if ( strncmp(label,rangelabel[k],len)==0 && (label[len]==',' || label[len]==' ') )
+    break;
+    }
+    if ( k<3 && rangecnt[is_fr]<32 ) {
+	ranges[is_fr][rangecnt[is_fr]].start = first[is_fr];
+	ranges[is_fr][rangecnt[is_fr]].end = a_char;
+	ranges[is_fr][rangecnt[is_fr]++].kind = k;
+    }
+    first[is_fr] = -1;
+}
+
 static char *myfgets(char *buf,int bsize,FILE *file) {
     /* NamesList.txt uses CR as a line separator */
     int ch;
@@ -132,37 +184,73 @@ return( NULL );
 return( buf );
 }
 
-static void InitArrays(void) {
-    int i,j;
-    for (i=0; i<2; i++) for (j=0; j<17*65536; j++) {
-	uninames[i][j] = uniannot[i][j] = NULL;
-	names2pt[i][j] = names2ln[i][j] = (char)(127);
+/* Names, annotations and block names are allocated from large chunks */
+/* and freed all at once. The last string made can grow in place, so a */
+/* long annotation read one line at a time costs linear time to build. */
+/* Each language has its own chunks, so both can be read at once.     */
+#define ARENASIZE (1<<20)
+static struct arena { struct arena *next; size_t used, size; } *arena[2];
+static char *arenalast[2];
+static size_t arenalastlen[2];
+
+static char *arenaalloc(int l, size_t len) {
+    struct arena *cur;
+    size_t size;
+    char *pt;
+
+    if ( arena[l]==NULL || arena[l]->used+len>arena[l]->size ) {
+	size = len>ARENASIZE ? len : ARENASIZE;
+	if ( (cur=(struct arena *)(malloc(sizeof(struct arena)+size)))==NULL )
+	    return( NULL );
+	cur->next = arena[l]; cur->used = 0; cur->size = size;
+	arena[l] = cur;
     }
-    names2cnt[0] = names2cnt[1] = 0;
+    pt = (char *)(arena[l]+1)+arena[l]->used;
+    arena[l]->used += len;
+    return( pt );
 }
 
-static void FreeArrays(void) {
-    int i,j;
-    for (i=0; i<2; i++) for (j=0; j<17*65536; j++) {
-	free(uninames[i][j]); free(uniannot[i][j]);
+/* Return str with add appended, or a copy of add if str is NULL */
+static char *arenacat(int l, char *str, const char *add) {
+    size_t len, n = strlen(add);
+    char *pt;
+
+    if ( str!=NULL && str==arenalast[l] && arena[l]->used+n<=arena[l]->size ) {
+	memcpy(str+arenalastlen[l],add,n+1);
+	arena[l]->used += n; arenalastlen[l] += n;
+	return( str );
     }
+    len = str==NULL ? 0 : (str==arenalast[l] ? arenalastlen[l] : strlen(str));
+    if ( (pt=arenaalloc(l,len+n+1))==NULL )
+	return( NULL );
+    if ( len>0 ) memcpy(pt,str,len);
+    memcpy(pt+len,add,n+1);
+    arenalast[l] = pt; arenalastlen[l] = len+n;
+    return( pt );
+}
+
+static void FreeArrays(void) {
+    struct arena *next;
+    struct block *temp;
+    int i;
 
     for (i=0; i<2; i++) {
-	struct block *temp;
+	for ( ; arena[i]!=NULL; arena[i]=next ) {
+	    next = arena[i]->next; free(arena[i]);
+	}
 	while ( head[i]!=NULL ) {
-	    if ( head[i]->name!=NULL ) free(head[i]->name);
 	    temp=head[i]->next; free(head[i]); head[i]=temp;
 	}
     }
 }
 
-static int ReadNamesList(void) {
+static int ReadNamesList(int i) {
     char buffer[BBUFFSIZE];
     FILE *nl;
     long int a_char = -1, first, last;
     char *end, *namestart, *pt, *temp;
     struct block *cur;
-    int i, j;
+    int j;
     static char *nameslistfiles[] = { "NamesList.txt", "ListeDesNoms.txt", NULL };
     static char *nameslistlocs[] = {
 	"http://www.unicode.org/Public/UNIDATA/NamesList.txt",
@@ -170,105 +258,109 @@ static int ReadNamesList(void) {
     };
 
     buffer[sizeof(buffer)-1]=0;
-    for ( i=0; nameslistfiles[i]!=NULL; ++i ) {
-	nl = fopen( nameslistfiles[i],"r" );
-	if ( nl==NULL ) {
-	    fprintf( stderr, "Cannot find %s. Please copy it from\n\t%s\n", nameslistfiles[i], nameslistlocs[i] );
-	    goto errorReadNamesListFO;
-	}
-	while ( myfgets(buffer,BBUFFSIZE-1,nl)!=NULL ) {
-	    if ( buffer[0]=='@' ) {
-		if ( buffer[1]=='+' && buffer[2]=='\t' ) {
-		    /* This is a Notice_line, @+ */
-		    if ( a_char>=0 && a_char<(int)(sizeof(uniannot[0])/sizeof(uniannot[0][0])) ) {
-			for ( pt=buffer; *pt && *pt!='\r' && *pt!='\n' ; ++pt );
-			if ( *pt=='\r' ) *pt='\n';
-			if ( uniannot[i][a_char]==NULL )
-			    uniannot[i][a_char] = strdup(buffer+2);
-			else {
-			    temp = (char *)(realloc(uniannot[i][a_char],strlen(uniannot[i][a_char])+strlen(buffer+2)+1));
-			    if ( temp==NULL ) goto errorReadNamesList;
-			    strcat(temp,buffer+2);
-			    uniannot[i][a_char] = temp;
-			}
-	continue;
-		    } else {
-		    ;
-		    }
+    nl = fopen( nameslistfiles[i],"r" );
+    if ( nl==NULL ) {
+	fprintf( stderr, "Cannot find %s. Please copy it from\n\t%s\n", nameslistfiles[i], nameslistlocs[i] );
+	goto errorReadNamesListFO;
+    }
+    while ( myfgets(buffer,BBUFFSIZE-1,nl)!=NULL ) {
+	if ( buffer[0]=='@' ) {
+	    if ( buffer[1]=='+' && buffer[2]=='\t' ) {
+		/* This is a Notice_line, @+ */
+		if ( a_char>=0 && a_char<(int)(sizeof(uniannot[0])/sizeof(uniannot[0][0])) ) {
+		    for ( pt=buffer; *pt && *pt!='\r' && *pt!='\n' ; ++pt );
+		    if ( *pt=='\r' ) *pt='\n';
+		    if ( (temp=arenacat(i,uniannot[i][a_char],buffer+2))==NULL )
+			goto errorReadNamesList;
+		    uniannot[i][a_char] = temp;
+    continue;
+		} else {
+		;
 		}
-		a_char = -1;
-		if ( buffer[1]=='@' && buffer[2]=='\t' ) {
-		    /* This is a Block_Header {first...last}, @@ */
-		    first = strtol(buffer+3,&end,16);
-		    if ( *end=='\t' ) {
-			namestart = end+1;
-			for ( pt=namestart; *pt!='\0' && *pt!='\t' ; ++pt );
-			if ( *pt=='\t' ) {
-			    *pt = '\0';
-			    last = strtol(pt+1,&end,16);
-			    if ( last>first ) {
-				/* found a block, record info */
-				cur = (struct block *)(malloc(sizeof(struct block)));
-				if ( cur==NULL ) goto errorReadNamesList;
-				cur->start = first;
-				cur->end = last;
-				cur->name = strdup(namestart);
-				if ( final[i]==NULL )
-				    head[i] = cur;
-				else
-				    final[i]->next = cur;
-				final[i] = cur;
+	    }
+	    a_char = -1;
+	    if ( buffer[1]=='@' && buffer[2]=='\t' ) {
+		/* This is a Block_Header {first...last}, @@ */
+		first = strtol(buffer+3,&end,16);
+		if ( *end=='\t' ) {
+		    namestart = end+1;
+		    for ( pt=namestart; *pt!='\0' && *pt!='\t' ; ++pt );
+		    if ( *pt=='\t' ) {
+			*pt = '\0';
+			last = strtol(pt+1,&end,16);
+			if ( last>first ) {
+			    /* found a block, record info */
+			    cur = (struct block *)(malloc(sizeof(struct block)));
+			    if ( cur==NULL ) goto errorReadNamesList;
+			    cur->start = first;
+			    cur->end = last;
+			    cur->next = NULL;
+			    if ( (cur->name=arenacat(i,NULL,namestart))==NULL ) {
+				free(cur);
+				goto errorReadNamesList;
 			    }
+			    if ( final[i]==NULL )
+				head[i] = cur;
+			    else
+				final[i]->next = cur;
+			    final[i] = cur;
 			}
 		    }
 		}
-	continue;
-	    } else if ( buffer[0]==';' ) {
-		/* comment, ignore */
-	continue;
-	    } else if ( (buffer[0]>='0' && buffer[0]<='9') || (buffer[0]>='A' && buffer[0]<='F') ) {
-		a_char = strtol(buffer,&end,16);
-		if ( *end!='\t' )
-	continue;
-		else if ( end[1]=='<' )
-	continue;
-		namestart = end+1;
-		for ( pt=namestart; *pt && *pt!='\r' && *pt!='\n' && *pt!='\t' && *pt!=';' ; ++pt );
-		*pt = '\0';
-		if ( a_char>=0 && a_char<(int)(sizeof(uninames[0])/sizeof(uninames[0][0])) )
-		    uninames[i][a_char] = strdup(namestart);
-	    } else if ( a_char==-1 ) {
-	continue;
-	    } else if ( buffer[0]=='\t' && buffer[1]==';' ) {
-	continue;		/* comment */
-	    } else if ( a_char>=0 && a_char<(int)(sizeof(uniannot[0])/sizeof(uniannot[0][0])) ) {
-		for ( pt=buffer; *pt && *pt!='\r' && *pt!='\n' ; ++pt );
-		if ( *pt=='\r' ) *pt='\n';
-		if ( uniannot[i][a_char]==NULL )
-		    uniannot[i][a_char] = strdup(buffer);
-		else {
-		    temp = (char *)(realloc(uniannot[i][a_char],strlen(uniannot[i][a_char])+strlen(buffer)+1));
-		    if ( temp==NULL ) goto errorReadNamesList;
-		    strcat(temp,buffer);
-		    uniannot[i][a_char] = temp;
-		}
 	    }
+    continue;
+	} else if ( buffer[0]==';' ) {
+	    /* comment, ignore */
+    continue;
+	} else if ( (buffer[0]>='0' && buffer[0]<='9') || (buffer[0]>='A' && buffer[0]<='F') ) {
+	    a_char = strtol(buffer,&end,16);
+	    if ( *end!='\t' )
+    continue;
+	    else if ( end[1]=='<' ) {
+		readrange(i,a_char,end+2);
+    continue;
+	    }
+	    namestart = end+1;
+	    for ( pt=namestart; *pt && *pt!='\r' && *pt!='\n' && *pt!='\t' && *pt!=';' ; ++pt );
+	    *pt = '\0';
+	    if ( a_char>=0 && a_char<(int)(sizeof(uninames[0])/sizeof(uninames[0][0])) ) {
+		if ( (uninames[i][a_char]=arenacat(i,NULL,namestart))==NULL )
+		    goto errorReadNamesList;
+	    }
+	} else if ( a_char==-1 ) {
+    continue;
+	} else if ( buffer[0]=='\t' && buffer[1]==';' ) {
+    continue;		/* comment */
+	} else if ( a_char>=0 && a_char<(int)(sizeof(uniannot[0])/sizeof(uniannot[0][0])) ) {
+	    for ( pt=buffer; *pt && *pt!='\r' && *pt!='\n' ; ++pt );
+	    if ( *pt=='\r' ) *pt='\n';
+	    if ( (temp=arenacat(i,uniannot[i][a_char],buffer))==NULL )
+		goto errorReadNamesList;
+	    uniannot[i][a_char] = temp;
 	}
-	fclose(nl);
-
-	/* search for possible normalized aliases. Assume 1st annotation line */
-	for ( a_char=0; a_char<17*65536; ++a_char ) if ( uniannot[i][a_char]!=NULL ) {
-	    pt = uniannot[i][a_char];
-	    if ( *pt=='\t' && *++pt=='%' && *++pt==' ' ) {
-		for ( j=-1; *pt!='\n' && *pt!='\0'; ++j,++pt );
-		if ( j>0 && j<127 ) {
-		    names2pt[i][a_char] = 3;
-		    names2ln[i][a_char] = (char)(j);
-		    names2cnt[i]++;
-		}
+    }
+    fclose(nl);
+
+    /* search for possible normalized aliases. Assume 1st annotation line */
+    for ( a_char=0; a_char<17*65536; ++a_char ) if ( uniannot[i][a_char]!=NULL ) {
+	pt = uniannot[i][a_char];
+	if ( *pt=='\t' && *++pt=='%' && *++pt==' ' ) {
+	    for ( j=-1; *pt!='\n' && *pt!='\0'; ++j,++pt );
+	    if ( j>0 && j<127 ) {
+		names2pt[i][a_char] = 3;
+		names2ln[i][a_char] = (char)(j);
+		names2cnt[i]++;
 	    }
 	}
     }
+
+    /* Longest strings, for UNICODE_NAME_MAX and UNICODE_ANNOT_MAX */
+    for ( a_char=0; a_char<17*65536; ++a_char ) {
+	if ( uninames[i][a_char]!=NULL && maxname[i]<strlen(uninames[i][a_char]) )
+	    maxname[i] = (unsigned int)(strlen(uninames[i][a_char]));
+	if ( uniannot[i][a_char]!=NULL && maxannot[i]<strlen(uniannot[i][a_char]) )
+	    maxannot[i] = (unsigned int)(strlen(uniannot[i][a_char]));
+    }
     return( 1 );
 
 errorReadNamesList:
@@ -278,13 +370,21 @@ errorReadNamesListFO:
     return( 0 );
 }
 
-static void dumpstring(char *str,FILE *out) {
+static void dumpstring(const char *str,FILE *out) {
+    size_t n;
+
     do {
 	putc( '"', out);
-	for ( ; *str!='\n' && *str!='\0'; ++str ) {
-	    if ( *str=='"' || *str=='\\' )
+	for ( ; *str!='\n' && *str!='\0'; str+=n ) {
+	    /* Write runs that need no escapes in one call */
+	    n = strcspn(str,"\"\\\n");
+	    if ( n>0 )
+		fwrite(str,1,n,out);
+	    else {
 		putc('\\',out);
-	    putc(*str,out);
+		putc(*str,out);
+		n = 1;
+	    }
 	}
 	if ( *str=='\n' && str[1]!='\0' )
 	    fprintf( out, "\\n\"\n\t" );
@@ -294,6 +394,152 @@ static void dumpstring(char *str,FILE *out) {
     } while ( *str );
 }
 
+/* Unicode blocks normally start and end on multiples of 16 codepoints */
+/* so for each 256 codepoint page, a row of 16 block numbers (-1 if no */
+/* block) is enough. Rows are shared between pages, which are mostly  */
+/* inside one block. A block that does not end on a multiple of 16 is */
+/* handled with a value<-1 in the row, pointing to a chunk holding 16 */
+/* block numbers. So, uniNamesList_blockNumber() never needs a search. */
+static int16_t findblock(int l, long uni) {
+    struct block *block;
+    int16_t bcnt;
+
+    for ( block = head[l], bcnt=0; block!=NULL; block=block->next, ++bcnt )
+	if ( uni>=block->start && uni<=block->end )
+	    return( bcnt );
+    return( -1 );
+}
+
+static int dumpblockindex(FILE *out, int is_fr) {
+    static PERTHREAD int16_t rows[0x1100][16], chunks[0x1100][16];
+    static PERTHREAD uint16_t page[0x1100];
+    int16_t row[16], chunk[16], bcnt;
+    unsigned int i, j, k, t, nrows, nchunks;
+    struct block *block;
+    long uni;
+    int l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    /* Blocks are in order, so sweep once instead of using findblock() */
+    block = head[l]; bcnt = 0;
+    for ( i=nrows=nchunks=0; i<0x1100; ++i ) {
+	for ( j=0; j<16; ++j ) {
+	    for ( t=0; t<16; ++t ) {
+		uni = (long)((i<<8)+(j<<4)+t);
+		for ( ; block!=NULL && block->end<uni; block=block->next, ++bcnt );
+		chunk[t] = block!=NULL && uni>=block->start ? bcnt : -1;
+	    }
+	    for ( t=1; t<16 && chunk[t]==chunk[0]; ++t );
+	    if ( t==16 )
+		row[j] = chunk[0];
+	    else {
+		for ( k=0; k<nchunks && memcmp(chunks[k],chunk,sizeof(chunk))!=0; ++k );
+		if ( k==nchunks )
+		    memcpy(chunks[nchunks++],chunk,sizeof(chunk));
+		row[j] = (int16_t)(-(int)(k)-2);
+	    }
+	}
+	for ( k=0; k<nrows && memcmp(rows[k],row,sizeof(row))!=0; ++k );
+	if ( k==nrows )
+	    memcpy(rows[nrows++],row,sizeof(row));
+	page[i] = (uint16_t)(k);
+    }
+
+    fprintf( out, "/* Block number for each 16 codepoints of a page, -1 if unlisted. */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const int16_t unicode_blockrow%s[%u][16] = {\n", lg[l], nrows );
+    for ( k=0; k<nrows; ++k ) {
+	fprintf( out, "\t{" );
+	for ( j=0; j<16; ++j )
+	    fprintf( out, " %d%s", rows[k][j], j!=15 ? "," : "" );
+	fprintf( out, " }%s\n", k+1<nrows ? "," : "" );
+    }
+    fprintf( out, "};\n\n" );
+    if ( nchunks>0 ) {
+	fprintf( out, "/* Block numbers for rows above holding n<-1, see chunk -n-2 here. */\n" );
+	fprintf( out, "UN_DLL_LOCAL\nstatic const int16_t unicode_blockchunk%s[%u][16] = {\n", lg[l], nchunks );
+	for ( k=0; k<nchunks; ++k ) {
+	    fprintf( out, "\t{" );
+	    for ( j=0; j<16; ++j )
+		fprintf( out, " %d%s", chunks[k][j], j!=15 ? "," : "" );
+	    fprintf( out, " }%s\n", k+1<nchunks ? "," : "" );
+	}
+	fprintf( out, "};\n\n" );
+    }
+    fprintf( out, "/* Row of unicode_blockrow%s[] to use for each 256 codepoint page. */\n", lg[l] );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint16_t unicode_blockpage%s[0x1100] = {", lg[l] );
+    for ( i=0; i<0x1100; ++i )
+	fprintf( out, "%s%u%s", (i&15) ? " " : "\n\t", page[i], i+1<0x1100 ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+
+    fprintf( out, "/* Return block number for this unicode value, -1 if unlisted unicode value */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_blockNumber%s(unsigned long uni) {\n", lg[l] );
+    fprintf( out, "\tint b=-1;\n\n\tif ( uni<0x110000 ) {\n" );
+    fprintf( out, "\t\tb=unicode_blockrow%s[unicode_blockpage%s[uni>>8]][(uni>>4)&0xf];\n", lg[l], lg[l] );
+    if ( nchunks>0 )
+	fprintf( out, "\t\tif ( b<-1 )\n\t\t\tb=unicode_blockchunk%s[-b-2][uni&0xf];\n", lg[l] );
+    fprintf( out, "\t}\n\treturn( b );\n}\n\n" );
+    return( 1 );
+}
+
+/* names2 lookups use a bitmap of the unicode values with names2 for each */
+/* page that has any, and the names2 count before each 32bit word of it. */
+static int dumpnames2bits(FILE *out, int is_fr) {
+    static PERTHREAD uint32_t bits[0x1100][8];
+    static PERTHREAD unsigned int page[0x1100], rank[0x1100][8];
+    unsigned int i, j, k, n, np;
+    long a_char;
+    int l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    for ( i=np=n=0; i<0x1100; ++i ) {
+	page[i] = 0;
+	for ( j=0; j<256; ++j ) {
+	    a_char = (long)((i<<8)+j);
+	    if ( names2pt[l][a_char]==0 )
+    continue;
+	    if ( page[i]==0 ) {
+		page[i] = ++np;
+		memset(bits[np-1],0,sizeof(bits[0]));
+	    }
+	    bits[np-1][j>>5] |= 1u<<(j&31);
+	}
+	if ( page[i]>0 ) for ( k=0; k<8; ++k ) {
+	    rank[np-1][k] = n;
+	    for ( j=0; j<32; ++j ) n += (bits[np-1][k]>>j)&1;
+	}
+    }
+    if ( n!=(unsigned int)(names2cnt[l]) ) {
+	fprintf( stderr, "Cannot make names2 bitmap\n" );
+	return( 0 );
+    }
+
+    fprintf( out, "/* Page of unicode_name2bits%s[] for each 256 codepoints, plus one (0=none). */\n", lg[l] );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const %s unicode_name2page%s[0x1100] = {", np<256 ? "uint8_t" : "uint16_t", lg[l] );
+    for ( i=0; i<0x1100; ++i )
+	fprintf( out, "%s%u%s", (i&31) ? " " : "\n\t", page[i], i+1<0x1100 ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+    fprintf( out, "/* Unicode values with names2 in each page, and names2 count before each word. */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_name2bits%s[%u][8] = {\n", lg[l], np );
+    for ( k=0; k<np; ++k ) {
+	fprintf( out, "\t{" );
+	for ( j=0; j<8; ++j )
+	    fprintf( out, " 0x%08X%s", bits[k][j], j!=7 ? "," : "" );
+	fprintf( out, " }%s\n", k+1<np ? "," : "" );
+    }
+    fprintf( out, "};\n\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const %s unicode_name2rank%s[%u][8] = {\n", n<65536 ? "uint16_t" : "uint32_t", lg[l], np );
+    for ( k=0; k<np; ++k ) {
+	fprintf( out, "\t{" );
+	for ( j=0; j<8; ++j )
+	    fprintf( out, " %u%s", rank[k][j], j!=7 ? "," : "" );
+	fprintf( out, " }%s\n", k+1<np ? "," : "" );
+    }
+    fprintf( out, "};\n\n" );
+    return( 1 );
+}
+
 static int dumpinit(FILE *out, FILE *header, int is_fr) {
     /* is_fr => 0=english, 1=french */
     int i, l;
@@ -301,32 +547,32 @@ static int dumpinit(FILE *out, FILE *header, int is_fr) {
 
     l = is_fr; if ( is_fr<0 ) l = 0;
 
+    if ( is_fr==0 )
+	fprintf( out, "#if defined(HAVE_DLADDR) && !defined(_GNU_SOURCE)\n#define _GNU_SOURCE\n#endif\n" );
     fprintf( out, "#include <stdio.h>\n" );
+    fprintf( out, "#include <stdlib.h>\n" );
+    fprintf( out, "#include <string.h>\n" );
+    fprintf( out, "#include <stdint.h>\n" );
+    if ( is_fr==0 ) {
+	fprintf( out, "#ifdef HAVE_MMAP\n#include <sys/mman.h>\n#endif\n" );
+	fprintf( out, "#ifdef HAVE_DLOPEN\n#include <dlfcn.h>\n#endif\n" );
+    }
     if ( is_fr<1 )
 	fprintf( out, "#include \"uninameslist.h\"\n" );
     else
 	fprintf( out, "#include \"uninameslist-fr.h\"\n" );
     /* note dll follows uninameslist*.h file */
-    fprintf( out, "#include \"nameslist-dll.h\"\n\n" );
+    fprintf( out, "#include \"nameslist-dll.h\"\n" );
+    /* libuninameslist-fr is loaded by name, see unicode_langpack() */
+    if ( is_fr==0 )
+	fprintf( out, "#if defined(WANTLIBOFR) && defined(HAVE_DLOPEN)\n#include \"nameslist-lang.h\"\n#endif\n" );
+    fprintf( out, "\n" );
 
     fprintf( out, "/* This file was generated using the program 'buildnameslist.c' */\n\n" );
 
     if ( is_fr<1 ) printcopyright1(out, is_fr);
     if ( is_fr==1 ) printcopyright2(out);
 
-    /* Added functions available in libuninameslist version 0.3 and higher. */
-    fprintf( out, "/* Retrieve a pointer to the name of a Unicode codepoint. */\n" );
-    fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_name%s(unsigned long uni) {\n", lg[l] );
-    fprintf( out, "\tconst char *pt=NULL;\n\n" );
-    fprintf( out, "\tif ( uni<0x110000 )\n" );
-    fprintf( out, "\t\tpt=UnicodeNameAnnot%s[uni>>16][(uni>>8)&0xff][uni&0xff].name;\n", lg[l] );
-    fprintf( out, "\treturn( pt );\n}\n\n" );
-    fprintf( out, "/* Retrieve a pointer to annotation details of a Unicode codepoint. */\n" );
-    fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_annot%s(unsigned long uni) {\n", lg[l] );
-    fprintf( out, "\tconst char *pt=NULL;\n\n" );
-    fprintf( out, "\tif ( uni<0x110000 )\n" );
-    fprintf( out, "\t\tpt=UnicodeNameAnnot%s[uni>>16][(uni>>8)&0xff][uni&0xff].annot;\n", lg[l] );
-    fprintf( out, "\treturn( pt );\n}\n\n" );
     fprintf( out, "/* Retrieve Nameslist.txt version number. */\n" );
     fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_NamesListVersion%s(void) {\n",lg[l] );
     fprintf( out, "\treturn( \"Nameslist-Version: %s\" );\n}\n\n", lgv[l] );
@@ -335,13 +581,8 @@ static int dumpinit(FILE *out, FILE *header, int is_fr) {
     fprintf( out, "/* Return number of blocks in this NamesList. */\n" );
     fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_blockCount%s(void) {\n", lg[l] );
     fprintf( out, "\treturn( %s );\n}\n\n", lgb[l] );
-    fprintf( out, "/* Return block number for this unicode value, -1 if unlisted unicode value */\n" );
-    fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_blockNumber%s(unsigned long uni) {\n", lg[l] );
-    fprintf( out, "\tint i;\n\n\tif ( uni<0x110000 ) {\n" );
-    fprintf( out, "\t\tfor (i=0; i<%s; i++) {\n", lgb[l] );
-    fprintf( out, "\t\t\tif ( uni<(unsigned long)(UnicodeBlock%s[i].start) ) break;\n", lg[l] );
-    fprintf( out, "\t\t\tif ( uni<=(unsigned long)(UnicodeBlock%s[i].end) ) return( i );\n", lg[l] );
-    fprintf( out, "\t\t}\n\t}\n\treturn( -1 );\n}\n\n" );
+    if ( !dumpblockindex(out,is_fr) )
+	return( 0 );
     fprintf( out, "/* Return unicode value starting this Unicode block (-1 if bad uniBlock). */\n" );
     fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_blockStart%s(int uniBlock) {\n", lg[l] );
     fprintf( out, "\tif ( uniBlock<0 || uniBlock>=%s )\n\t\treturn( -1 );\n", lgb[l] );
@@ -360,10 +601,18 @@ static int dumpinit(FILE *out, FILE *header, int is_fr) {
     fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_names2cnt%s(void) {\n", lg[l] );
     fprintf( out, "\treturn( %d );\n}\n\n", names2cnt[l] );
 
+    /* Bit counting, used by the names2 and named codepoint bitmaps */
+    fprintf( out, "#if defined(__GNUC__) || defined(__clang__)\n#define UN_POPCOUNT(x)\t__builtin_popcount(x)\n" );
+    fprintf( out, "#define UN_LOWBIT(x)\t__builtin_ctz(x)\n#else\n" );
+    fprintf( out, "#define UN_LOWBIT(x)\tUN_POPCOUNT(((x)&(0u-(x)))-1u)\n" );
+    fprintf( out, "#define UN_POPCOUNT(x)\tunicode_popcount(x)\n" );
+    fprintf( out, "static int unicode_popcount(uint32_t x) {\n" );
+    fprintf( out, "\tx=x-((x>>1)&0x55555555u);\n\tx=(x&0x33333333u)+((x>>2)&0x33333333u);\n" );
+    fprintf( out, "\treturn( (int)((((x+(x>>4))&0x0f0f0f0fu)*0x01010101u)>>24) );\n}\n#endif\n\n" );
     if ( names2cnt[l]>0 ) {
-	fprintf( out, "static const unsigned long unicode_name2code%s[] = {", lg[l] );
+	fprintf( out, "UN_DLL_LOCAL\nstatic const unsigned long unicode_name2code%s[] = {", lg[l] );
 	for ( i=0,a_char=0; i<names2cnt[l] && a_char<0x110000; ++a_char ) {
-	    if ( names2pt[l][a_char]>=0 && names2pt[l][a_char]<127) {
+	    if ( names2pt[l][a_char]!=0 ) {
 		if ( i&7 ) fprintf( out, " " ); else fprintf( out, "\n\t" );
 		if ( a_char<=0xffff )
 		    fprintf( out, "0x%04X", (int)(a_char) );
@@ -374,14 +623,16 @@ static int dumpinit(FILE *out, FILE *header, int is_fr) {
 	}
 	fprintf( out, "\n};\n\n" );
 
-	fprintf( out, "static const char unicode_name2vals%s[] = {", lg[l] );
+	fprintf( out, "UN_DLL_LOCAL\nstatic const char unicode_name2vals%s[] = {", lg[l] );
 	for ( i=0,a_char=0; i<names2cnt[l] && a_char<0x110000; ++a_char ) {
-	    if ( names2pt[l][a_char]>=0 && names2pt[l][a_char]<127) {
+	    if ( names2pt[l][a_char]!=0 ) {
 		if ( i&7 ) fprintf( out, " " ); else fprintf( out, "\n\t" );
 		fprintf( out, "%d,%d%s", names2pt[l][a_char], names2ln[l][a_char], ++i!=names2cnt[l]?",":"" );
 	    }
 	}
 	fprintf( out, "\n};\n\n" );
+	if ( !dumpnames2bits(out,is_fr) )
+	    return( 0 );
     }
 
     fprintf( out, "/* Return unicode value with names2 (0<=count<uniNamesList_names2cnt(). */\n" );
@@ -395,9 +646,10 @@ static int dumpinit(FILE *out, FILE *header, int is_fr) {
     fprintf( out, "/* Return list location for this unicode value. Return -1 if not found. */\n" );
     fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_names2getU%s(unsigned long uni) {\n", lg[l] );
     if ( names2cnt[l]>0 ) {
-	fprintf( out, "\tint i;\n\n\tif ( uni<0x110000 ) for ( i=0; i<%d; ++i ) {\n", names2cnt[l] );
-	fprintf( out, "\t\tif ( uni==unicode_name2code%s[i] ) return( i );\n", lg[l] );
-	fprintf( out, "\t\tif ( uni<unicode_name2code%s[i] ) break;\n\t}\n", lg[l] );
+	fprintf( out, "\tunsigned int p;\n\tuint32_t b;\n\n" );
+	fprintf( out, "\tif ( uni<0x110000 && (p=unicode_name2page%s[uni>>8])>0 && \\\n", lg[l] );
+	fprintf( out, "\t     ((b=unicode_name2bits%s[p-1][(uni>>5)&7])>>(uni&31)&1) )\n", lg[l] );
+	fprintf( out, "\t\treturn( (int)(unicode_name2rank%s[p-1][(uni>>5)&7])+UN_POPCOUNT(b&((1u<<(uni&31))-1)) );\n", lg[l] );
     }
     fprintf( out, "\treturn( -1 );\n}\n\n" );
     fprintf( out, "/* Stringlength of names2. Use this if you want to truncate annotations */\n" );
@@ -421,8 +673,8 @@ static int dumpinit(FILE *out, FILE *header, int is_fr) {
 	fprintf( out, "\tint c;\n\tconst char *pt;\n\n" );
 	fprintf( out, "\tif ( count<0 || count>=%d ) return( NULL );\n", names2cnt[l] );
 	fprintf( out, "\tc = unicode_name2vals%s[count<<1];\n", lg[l] );
-	fprintf( out, "\tpt = uniNamesList_annot((unsigned long)(uniNamesList_names2val%s(count)));\n", lg[l] );
-	fprintf( out, "\twhile ( --c>=0 ) ++pt;\n\treturn( pt );\n}\n\n" );
+	fprintf( out, "\tpt = uniNamesList_annot%s((unsigned long)(unicode_name2code%s[count]));\n", lg[l], lg[l] );
+	fprintf( out, "\treturn( pt==NULL ? NULL : pt+c );\n}\n\n" );
     }
     fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_names2anU%s(unsigned long uni) {\n", lg[l] );
     if ( names2cnt[l]<=0 )
@@ -431,94 +683,200 @@ static int dumpinit(FILE *out, FILE *header, int is_fr) {
 	fprintf( out, "\treturn( uniNamesList_names2anC%s(uniNamesList_names2getU%s(uni)) );\n}\n\n\n", lg[l], lg[l] );
 
     if ( is_fr==0 ) {
-	fprintf( out, "/* These functions are available in libuninameslist-20200413 and higher */\n\n" );
-	fprintf( out, "UN_DLL_LOCAL\nint uniNamesList_haveFR(unsigned int lang) {\n" );
-	fprintf( out, "#ifdef WANTLIBOFR\n\tif ( lang==1 ) return( 1 );\n#endif\n\treturn( 0 );\n}\n\n" );
-	fprintf( out, "#ifndef WANTLIBOFR\n/* make these internal stubs since there's no French lib */\n" );
-	fprintf( out, "UN_DLL_LOCAL const char *uniNamesList_NamesListVersionFR(void) {return( NULL );}\n" );
-	fprintf( out, "UN_DLL_LOCAL const char *uniNamesList_nameFR(unsigned long uni) {return( NULL );}\n" );
-	fprintf( out, "UN_DLL_LOCAL const char *uniNamesList_annotFR(unsigned long uni) {return( NULL );}\n" );
-	fprintf( out, "UN_DLL_LOCAL int uniNamesList_blockCountFR(void) {return( -1 );}\n" );
-	fprintf( out, "UN_DLL_LOCAL int uniNamesList_blockNumberFR(unsigned long uni) {return( -1 );}\n" );
-	fprintf( out, "UN_DLL_LOCAL long uniNamesList_blockStartFR(int uniBlock) {return( -1 );}\n" );
-	fprintf( out, "UN_DLL_LOCAL long uniNamesList_blockEndFR(int uniBlock) {return( -1 );}\n" );
-	fprintf( out, "UN_DLL_LOCAL const char *uniNamesList_blockNameFR(int uniBlock) {return( NULL );}\n" );
-	fprintf( out, "#endif\n\n/* Return language codes available from libraries. 0=English, 1=French. */\n" );
+	fprintf( out, "/* Each language pack, like libuninameslist-fr, has a table of its functions. */\n" );
+	fprintf( out, "/* Functions it does not have are NULL, and then English is used instead. */\n" );
+	fprintf( out, "struct unicode_langpack {\n\tconst char *(*NamesListVersion)(void);\n" );
+	fprintf( out, "\tconst char *(*name)(unsigned long uni);\n" );
+	fprintf( out, "\tconst char *(*annot)(unsigned long uni);\n\tint (*blockCount)(void);\n" );
+	fprintf( out, "\tint (*blockNumber)(unsigned long uni);\n" );
+	fprintf( out, "\tlong (*blockStart)(int uniBlock);\n\tlong (*blockEnd)(int uniBlock);\n" );
+	fprintf( out, "\tconst char *(*blockName)(int uniBlock);\n" );
+	fprintf( out, "\tint (*nameBatch)(const uint32_t *uni, size_t count, const char **names);\n" );
+	fprintf( out, "\tint (*annotBatch)(const uint32_t *uni, size_t count, const char **annots);\n" );
+	fprintf( out, "\tint (*blockNumberBatch)(const uint32_t *uni, size_t count, int *blocks);\n" );
+	fprintf( out, "\tint (*search)(const char *query, int flags, int (*fn)(unsigned long uni, const char *name, void *data), void *data);\n" );
+	fprintf( out, "\tint (*xrefs)(unsigned long uni, const uint32_t **out);\n" );
+	fprintf( out, "\tint (*xrefsBack)(unsigned long uni, const uint32_t **out);\n" );
+	fprintf( out, "\tconst char *(*annotDisplay)(unsigned long uni);\n" );
+	fprintf( out, "\tlong (*nextNamed)(unsigned long uni);\n" );
+	fprintf( out, "\tvoid *handle;\t\t\t/* from dlopen(), or NULL */\n};\n\n" );
+	fprintf( out, "/* Languages by lang number. With dlopen(), a pack is loaded from dlname */\n" );
+	fprintf( out, "/* the first time it is used, so programs using only English never map it. */\n" );
+	fprintf( out, "struct unicode_lang {\n\tconst char *code, *dlname;\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack;\n};\n\n" );
+	fprintf( out, "/* A pack that could not be loaded, so it is not tried again */\n" );
+	fprintf( out, "static const struct unicode_langpack unicode_nopack = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };\n" );
+	fprintf( out, "\n#if defined(WANTLIBOFR) && !defined(HAVE_DLOPEN)\n" );
+	fprintf( out, "static const struct unicode_langpack unicode_packFR = {\n" );
+	fprintf( out, "\tuniNamesList_NamesListVersionFR, uniNamesList_nameFR, uniNamesList_annotFR,\n" );
+	fprintf( out, "\tuniNamesList_blockCountFR, uniNamesList_blockNumberFR, uniNamesList_blockStartFR,\n" );
+	fprintf( out, "\tuniNamesList_blockEndFR, uniNamesList_blockNameFR, uniNamesList_nameBatchFR,\n" );
+	fprintf( out, "\tuniNamesList_annotBatchFR, uniNamesList_blockNumberBatchFR, uniNamesList_searchFR,\n" );
+	fprintf( out, "\tuniNamesList_xrefsFR, uniNamesList_xrefsBackFR, uniNamesList_annotDisplayFR,\n" );
+	fprintf( out, "\tuniNamesList_nextNamedFR, NULL\n" );
+	fprintf( out, "};\n#endif\n\n" );
+	fprintf( out, "static struct unicode_lang unicode_langs[] = {\n" );
+	fprintf( out, "\t{ \"EN\", NULL, NULL },\n" );
+	fprintf( out, "#if defined(WANTLIBOFR) && defined(HAVE_DLOPEN)\n" );
+	fprintf( out, "\t{ \"FR\", UN_FR_DLNAME, NULL }\n#elif defined(WANTLIBOFR)\n" );
+	fprintf( out, "\t{ \"FR\", NULL, &unicode_packFR }\n#else\n" );
+	fprintf( out, "\t{ \"FR\", NULL, &unicode_nopack }\n#endif\n};\n\n" );
+	fprintf( out, "#if defined(__GNUC__) || defined(__clang__)\n" );
+	fprintf( out, "#define UN_PACKGET(p)\t\t__atomic_load_n(&(p),__ATOMIC_ACQUIRE)\n" );
+	fprintf( out, "#define UN_PACKSET(p,o,n)\t__atomic_compare_exchange_n(&(p),&(o),(n),0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)\n" );
+	fprintf( out, "#else\n#define UN_PACKGET(p)\t\t(p)\n" );
+	fprintf( out, "#define UN_PACKSET(p,o,n)\t((p)=(n),1)\n#endif\n\n" );
+	fprintf( out, "#ifdef HAVE_DLOPEN\n" );
+	fprintf( out, "/* Pack functions are named uniNamesList_<name><code>, like uniNamesList_nameFR */\n" );
+	fprintf( out, "static const struct {\n\tconst char *name;\n\tsize_t offset;\n" );
+	fprintf( out, "} unicode_langsyms[] = {\n" );
+	fprintf( out, "\t{ \"NamesListVersion\", offsetof(struct unicode_langpack,NamesListVersion) },\n" );
+	fprintf( out, "\t{ \"name\", offsetof(struct unicode_langpack,name) },\n" );
+	fprintf( out, "\t{ \"annot\", offsetof(struct unicode_langpack,annot) },\n" );
+	fprintf( out, "\t{ \"blockCount\", offsetof(struct unicode_langpack,blockCount) },\n" );
+	fprintf( out, "\t{ \"blockNumber\", offsetof(struct unicode_langpack,blockNumber) },\n" );
+	fprintf( out, "\t{ \"blockStart\", offsetof(struct unicode_langpack,blockStart) },\n" );
+	fprintf( out, "\t{ \"blockEnd\", offsetof(struct unicode_langpack,blockEnd) },\n" );
+	fprintf( out, "\t{ \"blockName\", offsetof(struct unicode_langpack,blockName) },\n" );
+	fprintf( out, "\t{ \"nameBatch\", offsetof(struct unicode_langpack,nameBatch) },\n" );
+	fprintf( out, "\t{ \"annotBatch\", offsetof(struct unicode_langpack,annotBatch) },\n" );
+	fprintf( out, "\t{ \"blockNumberBatch\", offsetof(struct unicode_langpack,blockNumberBatch) },\n" );
+	fprintf( out, "\t{ \"search\", offsetof(struct unicode_langpack,search) },\n" );
+	fprintf( out, "\t{ \"xrefs\", offsetof(struct unicode_langpack,xrefs) },\n" );
+	fprintf( out, "\t{ \"xrefsBack\", offsetof(struct unicode_langpack,xrefsBack) },\n" );
+	fprintf( out, "\t{ \"annotDisplay\", offsetof(struct unicode_langpack,annotDisplay) },\n" );
+	fprintf( out, "\t{ \"nextNamed\", offsetof(struct unicode_langpack,nextNamed) }\n" );
+	fprintf( out, "};\n\n" );
+	fprintf( out, "/* Open dlname from the directory of this library first, so versions match. */\n" );
+	fprintf( out, "static void *unicode_langopen(const char *dlname) {\n" );
+	fprintf( out, "#ifdef HAVE_DLADDR\n\tDl_info info;\n\tchar path[1024];\n" );
+	fprintf( out, "\tconst char *pt;\n\tsize_t n;\n\tvoid *h;\n\n" );
+	fprintf( out, "\tif ( dladdr((void *)(uintptr_t)(&uniNamesList_Languages),&info)!=0 && info.dli_fname!=NULL && \\\n" );
+	fprintf( out, "\t     (pt=strrchr(info.dli_fname,'/'))!=NULL && (n=(size_t)(pt-info.dli_fname)+1)+strlen(dlname)<sizeof(path) ) {\n" );
+	fprintf( out, "\t\tmemcpy(path,info.dli_fname,n);\n\t\tstrcpy(path+n,dlname);\n" );
+	fprintf( out, "\t\tif ( (h=dlopen(path,RTLD_NOW|RTLD_LOCAL))!=NULL )\n" );
+	fprintf( out, "\t\t\treturn( h );\n\t}\n#endif\n" );
+	fprintf( out, "\treturn( dlopen(dlname,RTLD_NOW|RTLD_LOCAL) );\n}\n\n" );
+	fprintf( out, "/* Load the function table of language lg, or return unicode_nopack. */\n" );
+	fprintf( out, "static const struct unicode_langpack *unicode_langload(const struct unicode_lang *lg) {\n" );
+	fprintf( out, "\tstruct unicode_langpack *pack;\n\tchar sym[64];\n\tvoid *h, *pt;\n" );
+	fprintf( out, "\tsize_t i;\n\n" );
+	fprintf( out, "\tif ( lg->dlname==NULL || (h=unicode_langopen(lg->dlname))==NULL )\n" );
+	fprintf( out, "\t\treturn( &unicode_nopack );\n" );
+	fprintf( out, "\tif ( (pack=(struct unicode_langpack *)(calloc(1,sizeof(struct unicode_langpack))))==NULL ) {\n" );
+	fprintf( out, "\t\tdlclose(h);\n\t\treturn( &unicode_nopack );\n\t}\n" );
+	fprintf( out, "\tfor ( i=0; i<sizeof(unicode_langsyms)/sizeof(unicode_langsyms[0]); ++i ) {\n" );
+	fprintf( out, "\t\tsprintf(sym,\"uniNamesList_%%s%%s\",unicode_langsyms[i].name,lg->code);\n" );
+	fprintf( out, "\t\tif ( (pt=dlsym(h,sym))!=NULL )\n" );
+	fprintf( out, "\t\t\tmemcpy((char *)(pack)+unicode_langsyms[i].offset,&pt,sizeof(pt));\n" );
+	fprintf( out, "\t}\n\tif ( pack->NamesListVersion==NULL ) {\n" );
+	fprintf( out, "\t\tfree(pack); dlclose(h);\n\t\treturn( &unicode_nopack );\n\t}\n" );
+	fprintf( out, "\t/* The pack stays loaded until the program ends */\n" );
+	fprintf( out, "\tpack->handle=h;\n\treturn( pack );\n}\n#endif\n\n" );
+	fprintf( out, "/* Return the function table of language lang (not English), loading it */\n" );
+	fprintf( out, "/* the first time, or NULL if it is not available. */\n" );
+	fprintf( out, "static const struct unicode_langpack *unicode_langpack(unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack, *old=NULL;\n\n" );
+	fprintf( out, "\tif ( lang==0 || lang>=sizeof(unicode_langs)/sizeof(unicode_langs[0]) )\n" );
+	fprintf( out, "\t\treturn( NULL );\n" );
+	fprintf( out, "\tif ( (pack=UN_PACKGET(unicode_langs[lang].pack))==NULL ) {\n" );
+	fprintf( out, "#ifdef HAVE_DLOPEN\n\t\tpack=unicode_langload(&unicode_langs[lang]);\n" );
+	fprintf( out, "#else\n\t\tpack=&unicode_nopack;\n#endif\n" );
+	fprintf( out, "\t\tif ( !UN_PACKSET(unicode_langs[lang].pack,old,pack) ) {\n" );
+	fprintf( out, "\t\t\t/* Another thread loaded it first, so drop this one */\n" );
+	fprintf( out, "#ifdef HAVE_DLOPEN\n\t\t\tif ( pack!=&unicode_nopack ) {\n" );
+	fprintf( out, "\t\t\t\tdlclose(pack->handle);\n" );
+	fprintf( out, "\t\t\t\tfree((void *)(uintptr_t)(pack));\n\t\t\t}\n#endif\n" );
+	fprintf( out, "\t\t\tpack=old;\n\t\t}\n\t}\n" );
+	fprintf( out, "\treturn( pack==&unicode_nopack ? NULL : pack );\n}\n\n" );
+	fprintf( out, "/* These functions are available in libuninameslist-20200413 and higher */\n" );
+	fprintf( out, "\n" );
+	fprintf( out, "/* Return language codes available from libraries. 0=English, 1=French. */\n" );
 	fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_Languages(unsigned int lang) {\n" );
-	fprintf( out, "\tif ( uniNamesList_haveFR(lang) )\n\t\treturn( \"FR\" );\n" );
-	fprintf( out, "\telse if ( lang==0 )\n\t\treturn( \"EN\" );\n\treturn( NULL );\n}\n\n" );
-	fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_NamesListVersionAlt(unsigned int lang) {\n" );
-	fprintf( out, "\tif ( uniNamesList_haveFR(lang) )\n\t\treturn( (const char *)(uniNamesList_NamesListVersionFR()) );\n" );
-	fprintf( out, "\telse if ( lang==0 )\n\t\treturn( uniNamesList_NamesListVersion() );\n\treturn( NULL );\n}\n\n" );
+	fprintf( out, "\tif ( lang==0 )\n\t\treturn( \"EN\" );\n" );
+	fprintf( out, "\tif ( unicode_langpack(lang)!=NULL )\n" );
+	fprintf( out, "\t\treturn( unicode_langs[lang].code );\n\treturn( NULL );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "const char *uniNamesList_NamesListVersionAlt(unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n\n" );
+	fprintf( out, "\tif ( pack!=NULL )\n\t\treturn( pack->NamesListVersion() );\n" );
+	fprintf( out, "\telse if ( lang==0 )\n\t\treturn( uniNamesList_NamesListVersion() );\n" );
+	fprintf( out, "\treturn( NULL );\n}\n\n" );
 	fprintf( out, "/* Return pointer to name/annotation for this unicode value using lang. */\n" );
 	fprintf( out, "/* Return English if language does not have information for this Ucode. */\n" );
-	fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_nameAlt(unsigned long uni, unsigned int lang) {\n" );
-	fprintf( out, "\tconst char *pt=NULL;\n\n\tif ( uni<0x110000 ) {\n" );
-	fprintf( out, "\t\tif ( uniNamesList_haveFR(lang) )\n\t\t\tpt=(const char *)(uniNamesList_nameFR(uni));\n" );
-	fprintf( out, "\t\tif ( pt==NULL )\n\t\t\tpt=uniNamesList_name(uni);\n\t}\n\treturn( pt );\n}\n\n" );
-	fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_annotAlt(unsigned long uni, unsigned int lang) {\n" );
-	fprintf( out, "\tconst char *pt=NULL;\n\n\tif ( uni<0x110000 ) {\n" );
-	fprintf( out, "\t\tif ( uniNamesList_haveFR(lang) )\n\t\t\tpt=(const char *)(uniNamesList_annotFR(uni));\n" );
-	fprintf( out, "\t\tif ( pt==NULL )\n\t\t\tpt=uniNamesList_annot(uni);\n\t}\n\treturn( pt );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "const char *uniNamesList_nameAlt(unsigned long uni, unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tconst char *pt=NULL;\n\n" );
+	fprintf( out, "\tif ( uni<0x110000 ) {\n\t\tif ( pack!=NULL && pack->name!=NULL )\n" );
+	fprintf( out, "\t\t\tpt=pack->name(uni);\n\t\tif ( pt==NULL )\n" );
+	fprintf( out, "\t\t\tpt=uniNamesList_name(uni);\n\t}\n\treturn( pt );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "const char *uniNamesList_annotAlt(unsigned long uni, unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tconst char *pt=NULL;\n\n" );
+	fprintf( out, "\tif ( uni<0x110000 ) {\n\t\tif ( pack!=NULL && pack->annot!=NULL )\n" );
+	fprintf( out, "\t\t\tpt=pack->annot(uni);\n\t\tif ( pt==NULL )\n" );
+	fprintf( out, "\t\t\tpt=uniNamesList_annot(uni);\n\t}\n\treturn( pt );\n}\n\n" );
 	fprintf( out, "/* Returns 2 lang pointers to names/annotations for this unicode value, */\n" );
 	fprintf( out, "/* Return str0=English, and str1=language_version (or NULL if no info). */\n" );
-	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_nameBoth(unsigned long uni, unsigned int lang, const char **str0, const char **str1) {\n" );
-	fprintf( out, "\tint error=-1;\n\t*str0=*str1=NULL;\n\n\tif ( uni<0x110000 ) {\n" );
-	fprintf( out, "\t\terror=0;\n\t\t*str0=uniNamesList_name(uni);\n" );
-	fprintf( out, "\t\tif ( uniNamesList_haveFR(lang) )\n\t\t\t*str1=(const char *)(uniNamesList_nameFR(uni));\n" );
-	fprintf( out, "\t\telse if ( lang==0 )\n\t\t\t*str1=*str0;\n\t}\n\treturn( error );\n}\n\n" );
-	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_annotBoth(unsigned long uni, unsigned int lang, const char **str0, const char **str1) {\n" );
-	fprintf( out, "\tint error=-1;\n\t*str0=*str1=NULL;\n\n" );
-	fprintf( out, "\tif ( uni<0x110000 ) {\n\t\terror=0;\n\t\t*str0=uniNamesList_annot(uni);\n" );
-	fprintf( out, "\t\tif ( uniNamesList_haveFR(lang) )\n\t\t\t*str1=(const char *)(uniNamesList_annotFR(uni));\n" );
-	fprintf( out, "\t\telse if ( lang==0 )\n\t\t\t*str1=*str0;\n\t}\n\treturn( error );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "int uniNamesList_nameBoth(unsigned long uni, unsigned int lang, const char **str0, const char **str1) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tint error=-1;\n\n" );
+	fprintf( out, "\t*str0=*str1=NULL;\n\tif ( uni<0x110000 ) {\n\t\terror=0;\n" );
+	fprintf( out, "\t\t*str0=uniNamesList_name(uni);\n" );
+	fprintf( out, "\t\tif ( pack!=NULL && pack->name!=NULL )\n" );
+	fprintf( out, "\t\t\t*str1=pack->name(uni);\n\t\telse if ( lang==0 )\n" );
+	fprintf( out, "\t\t\t*str1=*str0;\n\t}\n\treturn( error );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "int uniNamesList_annotBoth(unsigned long uni, unsigned int lang, const char **str0, const char **str1) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tint error=-1;\n\n" );
+	fprintf( out, "\t*str0=*str1=NULL;\n\tif ( uni<0x110000 ) {\n\t\terror=0;\n" );
+	fprintf( out, "\t\t*str0=uniNamesList_annot(uni);\n" );
+	fprintf( out, "\t\tif ( pack!=NULL && pack->annot!=NULL )\n" );
+	fprintf( out, "\t\t\t*str1=pack->annot(uni);\n\t\telse if ( lang==0 )\n" );
+	fprintf( out, "\t\t\t*str1=*str0;\n\t}\n\treturn( error );\n}\n\n" );
 	fprintf( out, "/* Common access. Blocklists won't sync if they are different versions. */\n" );
 	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_blockCountAlt(unsigned int lang) {\n" );
-	fprintf( out, "\tint c=-1;\n\n\tif ( uniNamesList_haveFR(lang) )\n\t\tc=(int)(uniNamesList_blockCountFR());\n" );
-	fprintf( out, "\tif ( c<0 )\n\t\tc=UNICODE_EN_BLOCK_MAX;\n\treturn( c );\n}\n\n" );
-	fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_blockStartAlt(int uniBlock, unsigned int lang) {\n" );
-	fprintf( out, "\tlong c=-1;\n\n\tif ( uniNamesList_haveFR(lang) )\n\t\tc=(long)(uniNamesList_blockStartFR(uniBlock));\n" );
-	fprintf( out, "\tif ( c<0 )\n\t\tc=uniNamesList_blockStart(uniBlock);\n\treturn( c );\n}\n\n" );
-	fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_blockEndAlt(int uniBlock, unsigned int lang) {\n" );
-	fprintf( out, "\tlong c=-1;\n\n\tif ( uniNamesList_haveFR(lang) )\n" );
-	fprintf( out, "\t\tc=(long)(uniNamesList_blockEndFR(uniBlock));\n\tif ( c<0 )\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tint c=-1;\n\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->blockCount!=NULL )\n" );
+	fprintf( out, "\t\tc=pack->blockCount();\n\tif ( c<0 )\n\t\tc=UNICODE_EN_BLOCK_MAX;\n" );
+	fprintf( out, "\treturn( c );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "long uniNamesList_blockStartAlt(int uniBlock, unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tlong c=-1;\n\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->blockStart!=NULL )\n" );
+	fprintf( out, "\t\tc=pack->blockStart(uniBlock);\n\tif ( c<0 )\n" );
+	fprintf( out, "\t\tc=uniNamesList_blockStart(uniBlock);\n\treturn( c );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "long uniNamesList_blockEndAlt(int uniBlock, unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tlong c=-1;\n\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->blockEnd!=NULL )\n" );
+	fprintf( out, "\t\tc=pack->blockEnd(uniBlock);\n\tif ( c<0 )\n" );
 	fprintf( out, "\t\tc=uniNamesList_blockEnd(uniBlock);\n\treturn( c );\n}\n\n" );
-	fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_blockNameAlt(int uniBlock, unsigned int lang) {\n" );
-	fprintf( out, "\tconst char *pt=NULL;\n\n\tif ( uniNamesList_haveFR(lang) )\n" );
-	fprintf( out, "\t\tpt=(const char *)(uniNamesList_blockNameFR(uniBlock));\n\tif ( pt==NULL )\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "const char *uniNamesList_blockNameAlt(int uniBlock, unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tconst char *pt=NULL;\n\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->blockName!=NULL )\n" );
+	fprintf( out, "\t\tpt=pack->blockName(uniBlock);\n\tif ( pt==NULL )\n" );
 	fprintf( out, "\t\tpt=uniNamesList_blockName(uniBlock);\n\treturn( pt );\n}\n\n" );
-	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_blockNumberBoth(unsigned long uni, unsigned int lang, int *bn0, int *bn1) {\n" );
-	fprintf( out, "\tint error=-1;\n\n\t*bn0=*bn1=-1;\n\tif ( uni<0x110000 ) {\n" );
-	fprintf( out, "\t\terror=0;\n\t\t*bn0=uniNamesList_blockNumber(uni);\n" );
-	fprintf( out, "\t\tif ( uniNamesList_haveFR(lang) )\n\t\t\t*bn1=(int)(uniNamesList_blockNumberFR(uni));\n" );
-	fprintf( out, "\t\telse if ( lang==0 )\n\t\t\t*bn1=*bn0;\n\t}\n\treturn( error );\n}\n\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\n" );
+	fprintf( out, "int uniNamesList_blockNumberBoth(unsigned long uni, unsigned int lang, int *bn0, int *bn1) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tint error=-1;\n\n" );
+	fprintf( out, "\t*bn0=*bn1=-1;\n\tif ( uni<0x110000 ) {\n\t\terror=0;\n" );
+	fprintf( out, "\t\t*bn0=uniNamesList_blockNumber(uni);\n" );
+	fprintf( out, "\t\tif ( pack!=NULL && pack->blockNumber!=NULL )\n" );
+	fprintf( out, "\t\t\t*bn1=pack->blockNumber(uni);\n\t\telse if ( lang==0 )\n" );
+	fprintf( out, "\t\t\t*bn1=*bn0;\n\t}\n\treturn( error );\n}\n\n\n" );
     }
 
-    fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot nullarray%s[] = {\n", lg[l] );
-    for ( i=0; i<256/4 ; ++i )
-	fprintf( out, "\t{ NULL, NULL }, { NULL, NULL }, { NULL, NULL }, { NULL, NULL },\n" );
-    fprintf( out, "\t{ NULL, NULL }, { NULL, NULL }, { NULL, NULL }, { NULL, NULL }\n" );
-    fprintf( out, "};\n\n" );
-    fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot nullarray2%s[] = {\n", lg[l] );
-    for ( i=0; i<256/4 ; ++i )
-	fprintf( out, "\t{ NULL, NULL }, { NULL, NULL }, { NULL, NULL }, { NULL, NULL },\n" );
-    fprintf( out, "\t{ NULL, NULL }, { NULL, NULL },\n" );
-    if ( is_fr ) {
-	fprintf( out, "\t{ NULL, \"\t* on est assuré que la valeur ?FFFE n'est en aucune façon un caractère Unicode\" },\n" );
-	fprintf( out, "\t{ NULL, \"\t* on est assuré que la valeur ?FFFF n'est en aucune façon un caractère Unicode\" },\n" );
-    } else {
-	fprintf( out, "\t{ NULL, \"\t* the value ?FFFE is guaranteed not to be a Unicode character at all\" },\n" );
-	fprintf( out, "\t{ NULL, \"\t* the value ?FFFF is guaranteed not to be a Unicode character at all\" },\n" );
-    }
-    fprintf( out, "};\n\n" );
-    fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot * const nullnullarray%s[] = {\n", lg[l] );
-    for ( i=0; i<256/8 ; ++i )
-	fprintf( out, "\tnullarray%s, nullarray%s, nullarray%s, nullarray%s, nullarray%s, nullarray%s, nullarray%s, nullarray%s,\n", \
-			lg[l], lg[l], lg[l], lg[l], lg[l], lg[l], lg[l], lg[l] );
-    fprintf( out, "\tnullarray%s, nullarray%s, nullarray%s, nullarray%s, nullarray%s, nullarray%s, nullarray%s, nullarray2%s\n",
-			lg[l], lg[l], lg[l], lg[l], lg[l], lg[l], lg[l], lg[l] );
-    fprintf( out, "};\n\n" );
-
     if ( is_fr==1 ) {
 	/* default Nameslist.txt language=EN file holds these additional functions */
 	fprintf( header, "#ifndef UN_NAMESLIST_FR_H\n" );
@@ -528,10 +886,26 @@ static int dumpinit(FILE *out, FILE *header, int is_fr) {
 	fprintf( header, "# define UN_NAMESLIST_H\n\n" );
     }
     fprintf( header, "/* This file was generated using the program 'buildnameslist.c' */\n\n" );
+    fprintf( header, "#include <stddef.h>\n#include <stdint.h>\n\n" );
     fprintf( header, "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n" );
     if ( is_fr!=0 ) fprintf( header, "#ifndef UN_NAMESLIST_H\n" );
     fprintf( header, "struct unicode_block {\n\tint start, end;\n\tconst char *name;\n};\n\n" );
     fprintf( header, "struct unicode_nameannot {\n\tconst char *name, *annot;\n};\n" );
+    fprintf( header, "\nstruct unicode_text {\n\tsize_t offset;\n\tuint32_t uni;\n" );
+    fprintf( header, "\tint block;\n\tconst char *name;\n};\n" );
+    fprintf( header, "\n/* uniNamesList_search() finds names that start with query, that have */\n" );
+    fprintf( header, "/* query in them, or that have all the words of query in any order. */\n" );
+    fprintf( header, "#define UN_SEARCH_PREFIX\t0\n#define UN_SEARCH_SUBSTRING\t1\n#define UN_SEARCH_WORDS\t\t2\n" );
+    fprintf( header, "\n/* One line of an annotation, see uniNamesList_annotNext(). kind is the */\n" );
+    fprintf( header, "/* markup character below, or a tab for a comment continued on a line. */\n" );
+    fprintf( header, "/* text is the line after the markup (not '\\0' ended). seq[] has count */\n" );
+    fprintf( header, "/* codes: the x cross-reference, or the : # ~ sequence. name is the x */\n" );
+    fprintf( header, "/* name or the text after the sequence, and tag is the # <tag> if any. */\n" );
+    fprintf( header, "/* UN_ANNOT_SEQ_MAX is the longest decomposition, of U+FDFA. */\n" );
+    fprintf( header, "#define UN_ANNOT_SEQ_MAX\t18\n" );
+    fprintf( header, "struct unicode_annotline {\n\tconst char *text, *name, *tag;\n" );
+    fprintf( header, "\tsize_t len, namelen, taglen;\n\tint kind, count;\n" );
+    fprintf( header, "\tuint32_t seq[UN_ANNOT_SEQ_MAX];\n};\n" );
     if ( is_fr!=0 ) fprintf( header, "#endif\n" );
     fprintf( header, "\n" );
     return( 1 );
@@ -556,7 +930,11 @@ static int dumpend(FILE *header, int is_fr) {
     /* Added functions available in libuninameslist version 0.3 and higher. */
     /* Maintain this sequence for old-programs-binary-backwards-compatibility. */
     fprintf( header, "/* Return a pointer to the name for this unicode value */\n" );
-    fprintf( header, "/* This value points to a constant string inside the library */\n" );
+    fprintf( header, "/* This value points to a constant string inside the library, except */\n" );
+    fprintf( header, "/* names made from the unicode value (Hangul syllables, CJK and Tangut */\n" );
+    fprintf( header, "/* ideographs), or all names if built using './configure --enable-nametokens'. */\n" );
+    fprintf( header, "/* These are made in a buffer for this thread, which is valid until the */\n" );
+    fprintf( header, "/* next uniNamesList_name() on it. Use uniNamesList_nameBuf() to keep one. */\n" );
     fprintf( header, "const char *uniNamesList_name%s(unsigned long uni);\n\n", lg[l] );
     fprintf( header, "/* Returns pointer to the annotations for this unicode value */\n" );
     fprintf( header, "/* This value points to a constant string inside the library */\n" );
@@ -623,6 +1001,109 @@ static int dumpend(FILE *header, int is_fr) {
 	fprintf( header, "int uniNamesList_blockNumberBoth(unsigned long uni, unsigned int lang, int *bn0, int *bn1);\n\n" );
     }
 
+    fprintf( header, "/* These functions are available in libuninameslist-20261017 and higher */\n\n" );
+    fprintf( header, "/* Return unicode value for this character name. Return -1 if not found. */\n" );
+    fprintf( header, "/* Names must match exactly, len is the number of name characters used. */\n" );
+    fprintf( header, "long uniNamesList_codepoint%s(const char *name);\n", lg[l] );
+    fprintf( header, "long uniNamesList_codepointLen%s(const char *name, size_t len);\n\n", lg[l] );
+    fprintf( header, "/* Same using the loose matching rule UAX44-LM2, which ignores case, */\n" );
+    fprintf( header, "/* spaces, '_' and medial hyphens, like \"latin small letter a\". */\n" );
+    fprintf( header, "long uniNamesList_codepointLoose%s(const char *name);\n\n", lg[l] );
+    fprintf( header, "/* Copy name into buf, cut to size-1 characters. Return name length, */\n" );
+    fprintf( header, "/* like snprintf(), or -1 if there is no name for this unicode value. */\n" );
+    fprintf( header, "int uniNamesList_nameBuf%s(unsigned long uni, char *buf, size_t size);\n\n", lg[l] );
+    fprintf( header, "/* Fill names[]/annots[]/blocks[] for count unicode values (0=ok, -1=error). */\n" );
+    fprintf( header, "/* Bad unicode values give NULL pointers or block number -1, as above. */\n" );
+    fprintf( header, "/* Names that are made, as for uniNamesList_name(), are put in a buffer for */\n" );
+    fprintf( header, "/* this thread, valid until the next ...Batch() or text...() call on it. */\n" );
+    fprintf( header, "/* It grows to hold the names made by one call, and is not freed. */\n" );
+    fprintf( header, "/* nameBatch() gives -1, with NULL for these, if there is no memory. */\n" );
+    fprintf( header, "int uniNamesList_nameBatch%s(const uint32_t *uni, size_t count, const char **names);\n", lg[l] );
+    fprintf( header, "int uniNamesList_annotBatch%s(const uint32_t *uni, size_t count, const char **annots);\n", lg[l] );
+    fprintf( header, "int uniNamesList_blockNumberBatch%s(const uint32_t *uni, size_t count, int *blocks);\n\n", lg[l] );
+    if ( is_fr==0 ) {
+	fprintf( header, "/* Same as above using lang. Return English if language has no information. */\n" );
+	fprintf( header, "int uniNamesList_nameBatchAlt(const uint32_t *uni, size_t count, unsigned int lang, const char **names);\n" );
+	fprintf( header, "int uniNamesList_annotBatchAlt(const uint32_t *uni, size_t count, unsigned int lang, const char **annots);\n" );
+	fprintf( header, "int uniNamesList_blockNumberBatchAlt(const uint32_t *uni, size_t count, unsigned int lang, int *blocks);\n\n" );
+    }
+    fprintf( header, "/* Decode UTF-8 (or UTF-16) text, and return the offset, unicode value, */\n" );
+    fprintf( header, "/* block number and name of each character. Malformed input is U+FFFD. */\n" );
+    fprintf( header, "/* Fill up to max out[], return count filled, and *used=units consumed. */\n" );
+    fprintf( header, "/* A sequence (or surrogate pair) cut at the end of buf is not consumed, */\n" );
+    fprintf( header, "/* so if *used<len, pass the rest again with the next part of the text. */\n" );
+    fprintf( header, "/* At the end of the text, what is left is malformed (U+FFFD). Names are */\n" );
+    fprintf( header, "/* valid as for ...Batch(), and NULL if there is no memory to make them. */\n" );
+    fprintf( header, "size_t uniNamesList_textUTF8%s(const char *buf, size_t len, struct unicode_text *out, size_t max, size_t *used);\n", lg[l] );
+    fprintf( header, "size_t uniNamesList_textUTF16%s(const uint16_t *buf, size_t len, struct unicode_text *out, size_t max, size_t *used);\n\n", lg[l] );
+    fprintf( header, "/* Call fn() for each character of buf, which is all of the text, so a */\n" );
+    fprintf( header, "/* sequence cut at its end is U+FFFD. Return 0 when done, -1 if error, */\n" );
+    fprintf( header, "/* or else the non-zero value that fn() returned to stop early. t->name */\n" );
+    fprintf( header, "/* is only valid until fn() returns. */\n" );
+    fprintf( header, "int uniNamesList_textUTF8Call%s(const char *buf, size_t len, int (*fn)(const struct unicode_text *t, void *data), void *data);\n", lg[l] );
+    fprintf( header, "int uniNamesList_textUTF16Call%s(const uint16_t *buf, size_t len, int (*fn)(const struct unicode_text *t, void *data), void *data);\n\n", lg[l] );
+    fprintf( header, "/* Call fn() in unicode order for each name found by query, using flags */\n" );
+    fprintf( header, "/* UN_SEARCH_PREFIX, UN_SEARCH_SUBSTRING or UN_SEARCH_WORDS. ASCII case is */\n" );
+    fprintf( header, "/* ignored. name is only valid until fn() returns. Return 0 when done, */\n" );
+    fprintf( header, "/* -1 if error, or else the non-zero value that fn() returned to stop. */\n" );
+    fprintf( header, "int uniNamesList_search%s(const char *query, int flags, int (*fn)(unsigned long uni, const char *name, void *data), void *data);\n", lg[l] );
+    if ( is_fr==0 )
+	fprintf( header, "int uniNamesList_searchAlt(const char *query, int flags, unsigned int lang, int (*fn)(unsigned long uni, const char *name, void *data), void *data);\n" );
+    fprintf( header, "\n" );
+    fprintf( header, "/* Parse the annotation lines without copying, starting with *pos=0. */\n" );
+    fprintf( header, "/* Return 1 and fill line, 0 at the end of annot (or NULL), or -1 if error. */\n" );
+    fprintf( header, "int uniNamesList_annotNext%s(const char *annot, size_t *pos, struct unicode_annotline *line);\n\n", lg[l] );
+    fprintf( header, "/* Return count of unicode values in the x cross-references of this one, */\n" );
+    fprintf( header, "/* or that have it in their x cross-references with ...Back(), and point */\n" );
+    fprintf( header, "/* *out to them inside the library, or NULL if none. -1 if bad unicode value. */\n" );
+    fprintf( header, "int uniNamesList_xrefs%s(unsigned long uni, const uint32_t **out);\n", lg[l] );
+    fprintf( header, "int uniNamesList_xrefsBack%s(unsigned long uni, const uint32_t **out);\n", lg[l] );
+    if ( is_fr==0 ) {
+	fprintf( header, "int uniNamesList_xrefsAlt(unsigned long uni, unsigned int lang, const uint32_t **out);\n" );
+	fprintf( header, "int uniNamesList_xrefsBackAlt(unsigned long uni, unsigned int lang, const uint32_t **out);\n" );
+    }
+    fprintf( header, "\n" );
+    fprintf( header, "/* Return the annotations with the markup above replaced by the symbols, */\n" );
+    fprintf( header, "/* in UTF-8. These are kept in the library if built using './configure */\n" );
+    fprintf( header, "/* --enable-annotdisplay', else made in a buffer for this thread, which the */\n" );
+    fprintf( header, "/* next call reuses. */\n" );
+    fprintf( header, "const char *uniNamesList_annotDisplay%s(unsigned long uni);\n", lg[l] );
+    if ( is_fr==0 )
+	fprintf( header, "const char *uniNamesList_annotDisplayAlt(unsigned long uni, unsigned int lang);\n" );
+    fprintf( header, "\n" );
+    fprintf( header, "/* Return the first unicode value from uni on that has a name, or -1 if */\n" );
+    fprintf( header, "/* none. ...Block() and ...Plane() only look in that block or plane. To */\n" );
+    fprintf( header, "/* go through them all use: for ( u=..(0); u>=0; u=..(u+1) ) */\n" );
+    fprintf( header, "long uniNamesList_nextNamed%s(unsigned long uni);\n", lg[l] );
+    fprintf( header, "long uniNamesList_nextNamedBlock%s(unsigned long uni, int uniBlock);\n", lg[l] );
+    fprintf( header, "long uniNamesList_nextNamedPlane%s(unsigned long uni, unsigned int plane);\n", lg[l] );
+    if ( is_fr==0 )
+	fprintf( header, "long uniNamesList_nextNamedAlt(unsigned long uni, unsigned int lang);\n" );
+    fprintf( header, "\n" );
+    if ( is_fr==0 ) {
+	fprintf( header, "/* Open nameslist.dat or nameslist-fr.dat made by buildnameslist, so a */\n" );
+	fprintf( header, "/* newer NamesList can be used without building the library again. The */\n" );
+	fprintf( header, "/* file is mapped into memory if possible. Return NULL if not valid. */\n" );
+	fprintf( header, "struct unicode_names;\n" );
+	fprintf( header, "struct unicode_names *uniNamesList_open(const char *path);\n" );
+	fprintf( header, "void uniNamesList_close(struct unicode_names *file);\n\n" );
+	fprintf( header, "/* Same as the functions above, using the names in file. Only names, */\n" );
+	fprintf( header, "/* annotations, blocks and uniNamesList_codepoint() have ...File() */\n" );
+	fprintf( header, "/* versions, the file has no names2, xrefs, search or loose matching */\n" );
+	fprintf( header, "/* data, nor display annotations or nextNamed(). Names made from the */\n" );
+	fprintf( header, "/* unicode value are in a buffer for this thread, reused by the next call. */\n" );
+	fprintf( header, "const char *uniNamesList_LanguageFile(const struct unicode_names *file);\n" );
+	fprintf( header, "const char *uniNamesList_NamesListVersionFile(const struct unicode_names *file);\n" );
+	fprintf( header, "const char *uniNamesList_nameFile(unsigned long uni, const struct unicode_names *file);\n" );
+	fprintf( header, "const char *uniNamesList_annotFile(unsigned long uni, const struct unicode_names *file);\n" );
+	fprintf( header, "int uniNamesList_blockCountFile(const struct unicode_names *file);\n" );
+	fprintf( header, "int uniNamesList_blockNumberFile(unsigned long uni, const struct unicode_names *file);\n" );
+	fprintf( header, "long uniNamesList_blockStartFile(int uniBlock, const struct unicode_names *file);\n" );
+	fprintf( header, "long uniNamesList_blockEndFile(int uniBlock, const struct unicode_names *file);\n" );
+	fprintf( header, "const char *uniNamesList_blockNameFile(int uniBlock, const struct unicode_names *file);\n" );
+	fprintf( header, "long uniNamesList_codepointFile(const char *name, const struct unicode_names *file);\n\n" );
+    }
+
     fprintf( header, "#ifdef __cplusplus\n}\n#endif\n#endif\n" );
     return( 1 );
 }
@@ -630,7 +1111,7 @@ static int dumpend(FILE *header, int is_fr) {
 static int dumpblock(FILE *out, FILE *header, int is_fr ) {
     int bcnt, l;
     struct block *block;
-    unsigned int i, maxa, maxn;
+    unsigned int maxa, maxn;
 
     l = is_fr; if ( is_fr<0 ) l = 0;
 
@@ -646,19 +1127,13 @@ static int dumpblock(FILE *out, FILE *header, int is_fr ) {
     fprintf( header, "extern const struct unicode_block UnicodeBlock%s[%d];\n", lg[l], bcnt );
     if ( is_fr!=0 ) fprintf( header, "#define UnicodeBlock UnicodeBlock%s\n", lg[l] );
 
-    maxn = maxa = 0;
-    for ( i=0; i<sizeof(uniannot[is_fr])/sizeof(uniannot[0][is_fr]); ++i ) {
-	if ( uninames[is_fr][i]!=NULL && maxn<strlen(uninames[is_fr][i])) maxn = (unsigned int) strlen(uninames[is_fr][i]);
-	if ( uniannot[is_fr][i]!=NULL && maxa<strlen(uniannot[is_fr][i])) maxa = (unsigned int) strlen(uniannot[is_fr][i]);
-    }
-    if (maxn > max_n ) max_n = maxn;
-    if (maxa > max_a ) max_a = maxa;
+    maxn = maxname[l]; maxa = maxannot[l];
 
     fprintf( header, "\n/* NOTE: These %d constants are correct for this version of libuninameslist, */\n", is_fr ? 2: 4 );
     fprintf( header, "/* but can change for later versions of NamesList (use as an example guide) */\n" );
     if ( is_fr==0 ) {
-	fprintf( header, "#define UNICODE_NAME_MAX\t%d\n", max_n );
-	fprintf( header, "#define UNICODE_ANNOT_MAX\t%d\n", max_a );
+	fprintf( header, "#define UNICODE_NAME_MAX\t%d\n", maxname[0]>maxname[1] ? maxname[0] : maxname[1] );
+	fprintf( header, "#define UNICODE_ANNOT_MAX\t%d\n", maxannot[0]>maxannot[1] ? maxannot[0] : maxannot[1] );
 	fprintf( header, "#define UNICODE_EN_NAME_MAX\t%d\n", maxn );
 	fprintf( header, "#define UNICODE_EN_ANNOT_MAX\t%d\n", maxa );
     }
@@ -669,122 +1144,2506 @@ static int dumpblock(FILE *out, FILE *header, int is_fr ) {
     return( 1 );
 }
 
-static int dumparrays(FILE *out, FILE *header, int is_fr ) {
-    unsigned int i,j,k,t;
-    int l;
-    char *prefix = "una";
+/* Names and annotations are kept in two string pools, and the pages of */
+/* the sparse arrays only hold 32bit offsets into these pools (0==NULL). */
+/* This avoids a relocation for each string when loading the library. */
+static PERTHREAD uint32_t *nameofs, *annotofs, nullofs[2];
+
+/* uniNamesList_annotDisplay() replaces the markup at the beginning of the */
+/* annotation lines by these symbols. If built using './configure */
+/* --enable-annotdisplay', the annotations that change are also kept this */
+/* way in unicode_display[], with offset 0 where they are the same. */
+static const char annotmark[] = "*%x~:#";
+static const char *annotsymbol[6] = {
+    "\xE2\x80\xA2", "\xE2\x80\xBB", "\xE2\x86\x92", "\xE2\x81\x93", "\xE2\x89\xA1", "\xE2\x89\x88"
+};
+static PERTHREAD uint32_t *displayofs, nulldisplay[2], maxdisplay;
+
+/* Write str with its markup replaced into buf (3*strlen(str)+1 bytes). */
+/* Return 1 if buf is different from str. */
+static int displaystring(const char *str, char *buf) {
+    const char *m;
+    int bol=1, diff=0;
+
+    for ( ; *str!='\0'; ++str ) {
+	if ( bol && str[0]=='\t' && str[1]!='\0' && (m=strchr(annotmark,str[1]))!=NULL ) {
+	    *buf++ = '\t';
+	    strcpy(buf,annotsymbol[m-annotmark]);
+	    buf += strlen(buf);
+	    ++str;
+	    bol = 0; diff = 1;
+    continue;
+	}
+	bol = *str=='\n';
+	*buf++ = *str;
+    }
+    *buf = '\0';
+    return( diff );
+}
+
+static const char *nullannot[2][2] = {
+    { "\t* the value ?FFFE is guaranteed not to be a Unicode character at all",
+      "\t* the value ?FFFF is guaranteed not to be a Unicode character at all" },
+    { "\t* on est assuré que la valeur ?FFFE n'est en aucune façon un caractère Unicode",
+      "\t* on est assuré que la valeur ?FFFF n'est en aucune façon un caractère Unicode" }
+};
+
+/* Page kinds, 0=nullarray, 1=data, 2=nullarray2 (annotated ?FFFE,?FFFF) */
+static int pagekind(int is_fr, unsigned int plane, unsigned int j) {
+    unsigned int t;
+
+    for ( t=0; t<256; ++t ) {
+	if ( uninames[is_fr][(plane<<16) + (j<<8) + t]!=NULL || uniannot[is_fr][(plane<<16) + (j<<8) + t]!=NULL )
+    break;
+	else if ( j==0xff && t==0xfe -1 )
+    break;
+    }
+    if ( t==256 )
+	return( 0 );
+    if ( j==0xff && t==0xfe -1 )
+	return( 2 );
+    return( 1 );
+}
+
+/* Planes are asked about once per page, so remember each answer */
+static int emptyplane(int is_fr, unsigned int plane) {
+    static char known[2][17], empty[2][17];
+    unsigned int t;
+
+    if ( known[is_fr][plane] )
+	return( empty[is_fr][plane] );
+    for ( t=0; t<0xFFFE; ++t )
+	if ( uninames[is_fr][(plane<<16)+t]!=NULL || uniannot[is_fr][(plane<<16)+t]!=NULL )
+    break;
+    known[is_fr][plane] = 1;
+    empty[is_fr][plane] = (char)(t==0xFFFE);
+    return( t==0xFFFE );
+}
+
+/* Return length of string as dumped by dumpstring(), less trailing \n */
+static uint32_t dumplength(const char *str) {
+    size_t len = strlen(str);
+
+    if ( len>0 && str[len-1]=='\n' ) --len;
+    return( (uint32_t)(len) );
+}
+
+static void dumppoolstring(const char *str, FILE *out, uint32_t *ofs) {
+    putc('\t',out);
+    dumpstring(str,out);
+    fprintf( out, " \"\\0\"\n" );
+    *ofs += dumplength(str)+1;
+}
+
+/* Many strings in a pool are the same as another one, or are the end of */
+/* another one, like "LATIN CAPITAL LETTER A" in "FULLWIDTH LATIN CAPITAL */
+/* LETTER A". Such a string is not added, but points into the longer one. */
+/* Sorted by their reversed text, a string that ends another follows it. */
+struct poolstr {
+    const char *str;
+    uint32_t *ofs;		/* where its offset goes */
+    uint32_t len, tail;		/* tail is the one that holds it, or itself */
+};
+
+static int cmppooltail(const void *a, const void *b) {
+    const struct poolstr *sa = *(const struct poolstr * const *)(a);
+    const struct poolstr *sb = *(const struct poolstr * const *)(b);
+    uint32_t i;
+
+    for ( i=1; i<=sa->len && i<=sb->len; ++i )
+	if ( sa->str[sa->len-i]!=sb->str[sb->len-i] )
+	    return( (unsigned char)(sb->str[sb->len-i]) - (unsigned char)(sa->str[sa->len-i]) );
+    if ( sa->len!=sb->len )
+	return( sa->len<sb->len ? 1 : -1 );
+    return( sa<sb ? -1 : sa>sb );
+}
+
+/* Set tail for n strings, and return how many bytes sharing saves */
+static uint32_t pooltails(struct poolstr *strs, uint32_t n) {
+    struct poolstr **sorted, *prev;
+    uint32_t i, saved = 0;
+
+    for ( i=0; i<n; ++i ) strs[i].tail = i;
+    if ( n<2 || (sorted=(struct poolstr **)(malloc(n*sizeof(struct poolstr *))))==NULL )
+	return( 0 );
+    for ( i=0; i<n; ++i ) sorted[i] = strs+i;
+    qsort(sorted,n,sizeof(struct poolstr *),cmppooltail);
+    for ( i=1; i<n; ++i ) {
+	prev = sorted[i-1];
+	if ( sorted[i]->len<=prev->len && \
+	     memcmp(sorted[i]->str,prev->str+prev->len-sorted[i]->len,sorted[i]->len)==0 ) {
+	    sorted[i]->tail = prev->tail;
+	    saved += sorted[i]->len+1;
+	}
+    }
+    free(sorted);
+    return( saved );
+}
+
+/* Point the strings that were not added into those holding them */
+static void poolshared(struct poolstr *strs, uint32_t n) {
+    uint32_t i;
+
+    for ( i=0; i<n; ++i ) if ( strs[i].tail!=i )
+	*strs[i].ofs = *strs[strs[i].tail].ofs + strs[strs[i].tail].len - strs[i].len;
+}
+
+/* Dump n strings as part of the pool at ofs, less those that are shared */
+static uint32_t dumppoolstrs(struct poolstr *strs, uint32_t n, FILE *out, uint32_t *ofs) {
+    uint32_t i, saved = pooltails(strs,n);
+
+    for ( i=0; i<n; ++i ) if ( strs[i].tail==i ) {
+	*strs[i].ofs = *ofs;
+	dumppoolstring(strs[i].str,out,ofs);
+    }
+    poolshared(strs,n);
+    return( saved );
+}
+
+static int dumppool(FILE *out, int is_fr) {
+    struct poolstr *strs;
+    unsigned int i, j, k, u;
+    uint32_t ofs, n, saved;
+    char **bufs;
+    int l, changed;
 
     l = is_fr; if ( is_fr<0 ) l = 0;
 
-    for ( i=0; i<sizeof(uniannot[0])/(sizeof(uniannot[0][0])*65536); ++i ) {	/* For each plane */
-	for ( t=0; t<0xFFFE; ++t )
-	    if ( uninames[is_fr][(i<<16)+t]!=NULL || uniannot[is_fr][(i<<16)+t]!=NULL )
-	break;
-	if ( t==0xFFFE )
-    continue;		/* Empty plane */
-	for ( j=0; j<256; ++j ) {
-	    for ( t=0; t<256; ++t ) {
-		if ( uninames[is_fr][(i<<16) + (j<<8) + t]!=NULL || uniannot[is_fr][(i<<16) + (j<<8) + t]!=NULL )
-	    break;
-		else if ( j==0xff && t==0xfe -1 )
-	    break;
+    nameofs = (uint32_t *)(calloc(17*65536,sizeof(uint32_t)));
+    annotofs = (uint32_t *)(calloc(17*65536,sizeof(uint32_t)));
+    displayofs = (uint32_t *)(calloc(17*65536,sizeof(uint32_t)));
+    for ( u=n=ofs=0; u<17*65536; ++u ) {
+	if ( uninames[is_fr][u]!=NULL ) ++n;
+	if ( uniannot[is_fr][u]!=NULL ) ++ofs;
+    }
+    if ( n<ofs ) n = ofs;
+    strs = (struct poolstr *)(malloc((n+2)*sizeof(struct poolstr)));
+    bufs = (char **)(malloc((n+2)*sizeof(char *)));
+    if ( nameofs==NULL || annotofs==NULL || displayofs==NULL || strs==NULL || bufs==NULL ) {
+	fprintf( stderr, "Out of memory\n" );
+	free(strs); free(bufs);
+	return( 0 );
+    }
+
+    fprintf( out, "#if defined(__GNUC__)\n#pragma GCC diagnostic push\n" );
+    fprintf( out, "#pragma GCC diagnostic ignored \"-Woverlength-strings\"\n#endif\n" );
+    fprintf( out, "/* Annotations are used much less than names, so they are kept apart, */\n" );
+    fprintf( out, "/* in a section of their own where there is one, to keep the name tables */\n" );
+    fprintf( out, "/* and strings together in fewer cache lines and pages. */\n" );
+    fprintf( out, "#if (defined(__GNUC__) || defined(__clang__)) && defined(__ELF__)\n" );
+    fprintf( out, "#define UN_COLD __attribute__((section(\".rodata.unicode_annot\")))\n" );
+    fprintf( out, "#else\n#define UN_COLD\n#endif\n\n" );
+    fprintf( out, "/* All the annotations. Offset 0 is used for NULL strings. */\n" );
+    fprintf( out, "UN_DLL_LOCAL UN_COLD\nstatic const char unicode_annotpool%s[] = \"\\0\"\n", lg[l] );
+    ofs = 1; n = 0;
+    for ( i=0; i<17; ++i ) if ( !emptyplane(is_fr,i) ) {
+	for ( j=0; j<256; ++j ) if ( pagekind(is_fr,i,j)==1 ) {
+	    for ( k=0; k<256; ++k ) {
+		u = (i<<16) + (j<<8) + k;
+		if ( uniannot[is_fr][u]!=NULL ) {
+		    strs[n].str = uniannot[is_fr][u]; strs[n].ofs = &annotofs[u];
+		    strs[n++].len = dumplength(uniannot[is_fr][u]);
+		}
 	    }
-	    if ( t==256 || (j==0xff && t==0xfe -1))
-	continue;	/* Empty sub-plane */
-	    fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot %s%s_%02X_%02X[] = {\n", prefix, lg[l], i, j );
+	}
+    }
+    for ( k=0; k<2; ++k ) {
+	strs[n].str = nullannot[l][k]; strs[n].ofs = &nullofs[k];
+	strs[n++].len = dumplength(nullannot[l][k]);
+    }
+    saved = dumppoolstrs(strs,n,out,&ofs);
+    fprintf( out, "\t;\n\n" );
+    fprintf( out, "#ifndef WANTNAMETOKENS\n" );
+    fprintf( out, "/* All the names. Offset 0 is used for NULL strings. */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const char unicode_namepool%s[] = \"\\0\"\n", lg[l] );
+    ofs = 1; n = 0;
+    for ( i=0; i<17; ++i ) if ( !emptyplane(is_fr,i) ) {
+	for ( j=0; j<256; ++j ) if ( pagekind(is_fr,i,j)==1 ) {
 	    for ( k=0; k<256; ++k ) {
-		fprintf( out, "/* %04X */ { ", (i<<16) + (j<<8) + k );
-		if ( uninames[is_fr][(i<<16) + (j<<8) + k]==NULL )
-		    fprintf( out, "NULL" );
-		else
-		    dumpstring(uninames[is_fr][(i<<16) + (j<<8) + k],out);
-		putc(',',out);
-		if ( uniannot[is_fr][(i<<16) + (j<<8) + k]==NULL )
-		    fprintf( out, "NULL" );
-		else
-		    dumpstring(uniannot[is_fr][(i<<16) + (j<<8) + k],out);
-		fprintf( out, "}%s\n", k!=255?",":"" );
+		u = (i<<16) + (j<<8) + k;
+		if ( uninames[is_fr][u]!=NULL ) {
+		    strs[n].str = uninames[is_fr][u]; strs[n].ofs = &nameofs[u];
+		    strs[n++].len = dumplength(uninames[is_fr][u]);
+		}
 	    }
-	    fprintf( out, "};\n\n" );
 	}
     }
+    saved += dumppoolstrs(strs,n,out,&ofs);
+    fprintf( out, "\t;\n#endif\n\n" );
 
-    for ( i=0; i<sizeof(uniannot[is_fr])/(sizeof(uniannot[is_fr][0])*65536); ++i ) {	/* For each plane */
-	for ( t=0; t<0xFFFE; ++t )
-	    if ( uninames[is_fr][(i<<16)+t]!=NULL || uniannot[is_fr][(i<<16)+t]!=NULL )
-	break;
-	if ( t==0xFFFE )
-    continue;		/* Empty plane */
-	fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot * const %s%s_%02X[] = {\n", prefix, lg[l], i );
-	for ( j=0; j<256; ++j ) {
-	    for ( t=0; t<256; ++t ) {
-		if ( uninames[is_fr][(i<<16) + (j<<8) + t]!=NULL || uniannot[is_fr][(i<<16) + (j<<8) + t]!=NULL )
-	    break;
-		else if ( j==0xff && t==0xfe -1 )
-	    break;
-	    }
-	    if ( t==256 )
-		fprintf( out, "\tnullarray%s%s\n", lg[l], j!=255?",":"" );
-	    else if ( j==0xff && t==0xfe -1 )
-		fprintf( out, "\tnullarray2%s\n", lg[l] );
-	    else
-		fprintf( out, "\t%s%s_%02X_%02X%s\n", prefix, lg[l], i, j, j!=255?",":"" );
+    /* Same order as the annotations, leaving out those that do not change */
+    fprintf( out, "#ifdef WANTANNOTDISPLAY\n" );
+    fprintf( out, "/* Annotations as shown by uniNamesList_annotDisplay%s(), if they changed. */\n", lg[l] );
+    fprintf( out, "UN_DLL_LOCAL UN_COLD\nstatic const char unicode_display%s[] = \"\\0\"\n", lg[l] );
+    ofs = 1; n = 0; maxdisplay = 0;
+    for ( u=0; u<17*65536+2; ++u ) {
+	const char *str = u<17*65536 ? uniannot[is_fr][u] : nullannot[l][u-17*65536];
+	char *buf;
+
+	if ( str==NULL || (u<17*65536 && annotofs[u]==0) )
+    continue;
+	if ( (buf=(char *)(malloc(3*strlen(str)+1)))==NULL ) {
+	    fprintf( stderr, "Out of memory\n" );
+    break;
 	}
-	fprintf( out, "};\n\n" );
+	changed = displaystring(str,buf);
+	if ( maxdisplay<dumplength(buf) ) maxdisplay = dumplength(buf);
+	if ( !changed ) {
+	    free(buf);
+    continue;
+	}
+	bufs[n] = buf; strs[n].str = buf;
+	strs[n].ofs = u<17*65536 ? &displayofs[u] : &nulldisplay[u-17*65536];
+	strs[n++].len = dumplength(buf);
     }
+    if ( u==17*65536+2 )
+	dumppoolstrs(strs,n,out,&ofs);
+    for ( i=0; i<n; ++i ) free(bufs[i]);
+    free(strs); free(bufs);
+    fprintf( out, "\t;\n#endif\n" );
+    fprintf( out, "#if defined(__GNUC__)\n#pragma GCC diagnostic pop\n#endif\n\n" );
+    fprintf( stdout, "%s string pool: %u bytes saved by sharing the same text\n", is_fr ? "French" : "English", saved );
+    return( u==17*65536+2 );
+}
 
-    fprintf( header, "extern const struct unicode_nameannot * const *const UnicodeNameAnnot%s[];\n", lg[l] );
+/* Using './configure --enable-nametokens' names are kept as a list of */
+/* word numbers instead, one byte for the most used words and two bytes */
+/* for the others, ending with 0. Names are split into words at spaces, */
+/* and put back together with one space between each word when decoded. */
+static PERTHREAD uint32_t *tokofs;
 
-    fprintf( out, "UN_DLL_EXPORT\nconst struct unicode_nameannot * const *const UnicodeNameAnnot%s[] = {\n", lg[l] );
-    for ( i=0; i<sizeof(uniannot[is_fr])/(sizeof(uniannot[is_fr][0])*65536); ++i ) {	/* For each plane */
-	for ( t=0; t<0xFFFE; ++t )
-	    if ( uninames[is_fr][(i<<16)+t]!=NULL || uniannot[is_fr][(i<<16)+t]!=NULL )
-	break;
-	if ( t==0xFFFE )
-	    fprintf( out, "\tnullnullarray%s,\n", lg[l] );
+struct lexword {
+    const char *word;
+    size_t len;
+    uint32_t cnt, code;
+};
+
+static int cmplexword(const void *a, const void *b) {
+    const struct lexword *wa = (const struct lexword *)(a);
+    const struct lexword *wb = (const struct lexword *)(b);
+    int c;
+
+    if ( (c=memcmp(wa->word,wb->word,wa->len<wb->len ? wa->len : wb->len))!=0 )
+	return( c );
+    return( wa->len<wb->len ? -1 : wa->len>wb->len ? 1 : 0 );
+}
+
+static int cmplexcount(const void *a, const void *b) {
+    const struct lexword *wa = (const struct lexword *)(a);
+    const struct lexword *wb = (const struct lexword *)(b);
+
+    if ( wa->cnt!=wb->cnt )
+	return( wa->cnt>wb->cnt ? -1 : 1 );
+    return( cmplexword(a,b) );
+}
+
+/* Split name at spaces into w[], return count of words */
+static uint32_t splitwords(const char *name, struct lexword *w) {
+    const char *pt;
+    uint32_t n;
+
+    for ( n=0; ; ++n ) {
+	for ( pt=name; *pt!=' ' && *pt!='\0'; ++pt );
+	w[n].word = name;
+	w[n].len = (size_t)(pt-name);
+	w[n].cnt = 1;
+	if ( *pt=='\0' )
+    break;
+	name = pt+1;
+    }
+    return( n+1 );
+}
+
+static int dumptokens(FILE *out, int is_fr) {
+    struct lexword *w, *byname, key[128], *found;
+    unsigned char *tok;
+    char *buf;
+    uint32_t a_char, i, k, n, nw, one, ntok, ofs;
+    size_t maxn, strbytes;
+    int l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    for ( a_char=n=0, maxn=strbytes=0; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL ) {
+	n += splitwords(uninames[l][a_char],key);
+	strbytes += strlen(uninames[l][a_char])+1;
+	if ( maxn<strlen(uninames[l][a_char]) ) maxn = strlen(uninames[l][a_char]);
+    }
+    tokofs = (uint32_t *)(calloc(0x110000,sizeof(uint32_t)));
+    w = (struct lexword *)(malloc((n+1)*sizeof(struct lexword)));
+    byname = (struct lexword *)(malloc((n+1)*sizeof(struct lexword)));
+    tok = (unsigned char *)(malloc(3*(size_t)(n)+0x110000));
+    buf = (char *)(malloc(maxn+2));
+    if ( tokofs==NULL || w==NULL || byname==NULL || tok==NULL || buf==NULL ) {
+	fprintf( stderr, "Out of memory\n" );
+	free(w); free(byname); free(tok); free(buf);
+	return( 0 );
+    }
+
+    /* Count each different word, then number them, most used first */
+    for ( a_char=n=0; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL )
+	n += splitwords(uninames[l][a_char],w+n);
+    qsort(w,n,sizeof(struct lexword),cmplexword);
+    for ( i=nw=0; i<n; ++i ) {
+	if ( nw>0 && cmplexword(&w[i],&w[nw-1])==0 )
+	    ++w[nw-1].cnt;
 	else
-	    fprintf( out, "\t%s%s_%02X,\n", prefix, lg[l], i );
+	    w[nw++] = w[i];
+    }
+    qsort(w,nw,sizeof(struct lexword),cmplexcount);
+    for ( i=0; i<nw; ++i )
+	w[i].code = i;
+    /* Tokens 1..one-1 are words 0..one-2, and tokens one..255 start a */
+    /* two byte token for the remaining words, so find the largest one. */
+    for ( one=255; one>1 && nw>one-1 && (256-one)*256<nw-(one-1); --one );
+    if ( nw>one-1 && (256-one)*256<nw-(one-1) ) {
+	fprintf( stderr, "Too many different words in names\n" );
+	free(w); free(byname); free(tok); free(buf);
+	return( 0 );
+    }
+    memcpy(byname,w,nw*sizeof(struct lexword));
+    qsort(byname,nw,sizeof(struct lexword),cmplexword);
+
+    tok[0] = 0; ntok = 1;
+    for ( a_char=0; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL ) {
+	tokofs[a_char] = ntok;
+	n = splitwords(uninames[l][a_char],key);
+	for ( i=0; i<n; ++i ) {
+	    found = (struct lexword *)(bsearch(&key[i],byname,nw,sizeof(struct lexword),cmplexword));
+	    if ( found->code<one-1 )
+		tok[ntok++] = (unsigned char)(found->code+1);
+	    else {
+		k = found->code-(one-1);
+		tok[ntok++] = (unsigned char)(one+(k>>8));
+		tok[ntok++] = (unsigned char)(k&0xff);
+	    }
+	}
+	tok[ntok++] = 0;
+    }
+
+    /* Check that every name decodes back to what it was */
+    for ( a_char=0; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL ) {
+	buf[0] = '\0';
+	for ( i=tokofs[a_char], n=0; tok[i]!=0; ++n ) {
+	    k = tok[i++];
+	    k = k<one ? k-1 : (((k-one)<<8)|tok[i++])+one-1;
+	    if ( n>0 ) strcat(buf," ");
+	    strncat(buf,w[k].word,w[k].len);
+	}
+	if ( strcmp(buf,uninames[l][a_char])!=0 ) {
+	    fprintf( stderr, "Name tokens for U+%04X do not decode\n", a_char );
+	    free(w); free(byname); free(tok); free(buf);
+	    return( 0 );
+	}
+    }
+
+    fprintf( out, "#ifdef WANTNAMETOKENS\n" );
+    fprintf( out, "/* The %u different words used in names, most used first. */\n", nw );
+    fprintf( out, "#if defined(__GNUC__)\n#pragma GCC diagnostic push\n" );
+    fprintf( out, "#pragma GCC diagnostic ignored \"-Woverlength-strings\"\n#endif\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const char unicode_lexicon%s[] =", lg[l] );
+    for ( i=0; i<nw; ++i ) {
+	fprintf( out, "%s\"%.*s\"", (i&7) ? " " : "\n\t", (int)(w[i].len), w[i].word );
     }
-    while ( i<0x20 ) {
-	fprintf( out, "\tnullnullarray%s%s\n", lg[l], i!=0x20-1?",":"" );
-	++i;
+    fprintf( out, ";\n" );
+    fprintf( out, "#if defined(__GNUC__)\n#pragma GCC diagnostic pop\n#endif\n\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_lexofs%s[%u] = {", lg[l], nw+1 );
+    for ( i=ofs=0; i<=nw; ++i ) {
+	fprintf( out, "%s%u%s", (i&7) ? " " : "\n\t", ofs, i<nw ? "," : "" );
+	if ( i<nw ) ofs += (uint32_t)(w[i].len);
     }
+    fprintf( out, "\n};\n\n" );
+    fprintf( out, "/* Name tokens. Tokens 1..%u are words 0..%u, tokens %u..255 are the */\n", one-1, one-2, one );
+    fprintf( out, "/* high byte of a two byte token for words %u and up. 0 ends a name. */\n", one-1 );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const unsigned char unicode_nametok%s[%u] = {", lg[l], ntok );
+    for ( i=0; i<ntok; ++i )
+	fprintf( out, "%s%u%s", (i&15) ? " " : "\n\t", tok[i], i+1<ntok ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+
+    fprintf( out, "/* Decode the name tokens at unicode_nametok%s[o] into buf, return buf. */\n", lg[l] );
+    fprintf( out, "static const char *unicode_namedecode%s(uint32_t o, char *buf) {\n", lg[l] );
+    fprintf( out, "\tconst unsigned char *pt=unicode_nametok%s+o;\n", lg[l] );
+    fprintf( out, "\tchar *bpt=buf;\n\tuint32_t t, sp=0;\n\n" );
+    fprintf( out, "\twhile ( (t=*pt++)!=0 ) {\n" );
+    fprintf( out, "\t\tt = t<%u ? t-1 : (((t-%u)<<8)|*pt++)+%u;\n", one, one, one-1 );
+    fprintf( out, "\t\tif ( sp ) *bpt++=' ';\n\t\tsp=1;\n" );
+    fprintf( out, "\t\tmemcpy(bpt,unicode_lexicon%s+unicode_lexofs%s[t],unicode_lexofs%s[t+1]-unicode_lexofs%s[t]);\n", lg[l], lg[l], lg[l], lg[l] );
+    fprintf( out, "\t\tbpt+=unicode_lexofs%s[t+1]-unicode_lexofs%s[t];\n\t}\n", lg[l], lg[l] );
+    fprintf( out, "\t*bpt='\\0';\n\treturn( buf );\n}\n\n" );
+    fprintf( out, "#endif\n\n" );
+
+    fprintf( stdout, "%s names: %u bytes as strings, %u bytes as %u words and tokens\n",
+	     is_fr ? "French" : "English", (unsigned int)(strbytes), ntok+ofs+4*(nw+1), nw );
+    free(w); free(byname); free(tok); free(buf);
+    return( 1 );
+}
+
+static int dumpnamebuf(FILE *out, int is_fr) {
+    size_t maxn;
+    uint32_t a_char;
+    int k, l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    /* Names made from ranges are at most 27 characters */
+    for ( a_char=0, maxn=27; a_char<0x110000; ++a_char )
+	if ( uninames[l][a_char]!=NULL && maxn<strlen(uninames[l][a_char]) ) maxn = strlen(uninames[l][a_char]);
+
+    fprintf( out, "#if defined(_MSC_VER)\n#define UN_THREAD __declspec(thread)\n" );
+    fprintf( out, "#elif defined(__GNUC__) || defined(__clang__)\n#define UN_THREAD __thread\n" );
+    fprintf( out, "#else\n#define UN_THREAD _Thread_local\n#endif\n" );
+    fprintf( out, "#if defined(_MSC_VER)\n#define UN_INLINE __inline\n" );
+    fprintf( out, "#elif defined(__GNUC__) || defined(__clang__) || (defined(__STDC_VERSION__) && __STDC_VERSION__>=199901L)\n" );
+    fprintf( out, "#define UN_INLINE inline\n#else\n#define UN_INLINE\n#endif\n\n" );
+    fprintf( out, "/* Longest name, plus one */\n#define UN_NAMESIZE\t%u\n\n", (unsigned int)(maxn+1) );
+    fprintf( out, "/* Names that are made from the unicode value, or decoded from tokens, */\n" );
+    fprintf( out, "/* are put in buffers for each thread. uniNamesList_name() reuses one. */\n" );
+    fprintf( out, "static UN_THREAD char unicode_namebuf%s[UN_NAMESIZE];\n\n", lg[l] );
+    fprintf( out, "/* The ...Batch() and text...() functions put the names they make one */\n" );
+    fprintf( out, "/* after another in this arena, which the next such call reuses, so it */\n" );
+    fprintf( out, "/* only grows to the names made by one call. Until the call is done, */\n" );
+    fprintf( out, "/* the entries of these names point at unicode_namemark%s. */\n", lg[l] );
+    fprintf( out, "static UN_THREAD char *unicode_namearena%s;\n", lg[l] );
+    fprintf( out, "static UN_THREAD size_t unicode_namearenasize%s;\n", lg[l] );
+    fprintf( out, "static const char unicode_namemark%s[1] = \"\";\n\n", lg[l] );
+
+    if ( rangecnt[l]==0 )
+	return( 1 );
+    fprintf( out, "/* Names made from the unicode value, for the NamesList ranges <..., First> */\n" );
+    fprintf( out, "/* to <..., Last>. 0=Hangul syllables, 1=CJK unified ideographs, 2=Tangut */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_ranges%s[%d][3] = {\n", lg[l], rangecnt[l] );
+    for ( k=0; k<rangecnt[l]; ++k )
+	fprintf( out, "\t{ 0x%04lX, 0x%04lX, %ld }%s\n", ranges[l][k].start, ranges[l][k].end, ranges[l][k].kind,
+		 k+1<rangecnt[l] ? "," : "" );
     fprintf( out, "};\n\n" );
+    fprintf( out, "/* Hangul syllable names are made from the names of their jamo. */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const char unicode_jamoL%s[19][4] = {\n", lg[l] );
+    fprintf( out, "\t\"G\", \"GG\", \"N\", \"D\", \"DD\", \"R\", \"M\", \"B\", \"BB\", \"S\", \"SS\", \"\", \"J\", \"JJ\",\n" );
+    fprintf( out, "\t\"C\", \"K\", \"T\", \"P\", \"H\"\n};\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const char unicode_jamoV%s[21][4] = {\n", lg[l] );
+    fprintf( out, "\t\"A\", \"AE\", \"YA\", \"YAE\", \"EO\", \"E\", \"YEO\", \"YE\", \"O\", \"WA\", \"WAE\", \"OE\",\n" );
+    fprintf( out, "\t\"YO\", \"U\", \"WEO\", \"WE\", \"WI\", \"YU\", \"EU\", \"YI\", \"I\"\n};\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const char unicode_jamoT%s[28][4] = {\n", lg[l] );
+    fprintf( out, "\t\"\", \"G\", \"GG\", \"GS\", \"N\", \"NJ\", \"NH\", \"D\", \"L\", \"LG\", \"LM\", \"LB\", \"LS\", \"LT\",\n" );
+    fprintf( out, "\t\"LP\", \"LH\", \"M\", \"B\", \"BS\", \"S\", \"SS\", \"NG\", \"J\", \"C\", \"K\", \"T\", \"P\", \"H\"\n};\n\n" );
+    fprintf( out, "/* Names made from the code start with these. */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const char unicode_rangefixed%s[3][24] = {\n", lg[l] );
+    fprintf( out, "\t\"HANGUL SYLLABLE \", \"CJK UNIFIED IDEOGRAPH-\", \"TANGUT IDEOGRAPH-\"\n};\n\n" );
+    fprintf( out, "/* Make the name of uni into buf if it is in one of these ranges. */\n" );
+    fprintf( out, "static const char *unicode_rangename%s(unsigned long uni, char *buf) {\n", lg[l] );
+    fprintf( out, "\tunsigned int i, s;\n\n" );
+    fprintf( out, "\tfor ( i=0; i<%d; ++i ) if ( uni>=unicode_ranges%s[i][0] && uni<=unicode_ranges%s[i][1] ) {\n", rangecnt[l], lg[l], lg[l] );
+    fprintf( out, "\t\tif ( unicode_ranges%s[i][2]==1 )\n", lg[l] );
+    fprintf( out, "\t\t\tsprintf(buf,\"CJK UNIFIED IDEOGRAPH-%%04lX\",uni);\n" );
+    fprintf( out, "\t\telse if ( unicode_ranges%s[i][2]==2 )\n", lg[l] );
+    fprintf( out, "\t\t\tsprintf(buf,\"TANGUT IDEOGRAPH-%%04lX\",uni);\n\t\telse {\n" );
+    fprintf( out, "\t\t\ts=(unsigned int)(uni-0xAC00);\n" );
+    fprintf( out, "\t\t\tstrcpy(buf,\"HANGUL SYLLABLE \");\n" );
+    fprintf( out, "\t\t\tstrcat(buf,unicode_jamoL%s[s/588]);\n", lg[l] );
+    fprintf( out, "\t\t\tstrcat(buf,unicode_jamoV%s[s%%588/28]);\n", lg[l] );
+    fprintf( out, "\t\t\tstrcat(buf,unicode_jamoT%s[s%%28]);\n\t\t}\n\t\treturn( buf );\n", lg[l] );
+    fprintf( out, "\t}\n\treturn( NULL );\n}\n" );
+    fprintf( out, "/* Return 1 if uni is in one of these ranges, else 0. */\n" );
+    fprintf( out, "static int unicode_inrange%s(unsigned long uni) {\n\tunsigned int i;\n\n", lg[l] );
+    fprintf( out, "\tfor ( i=0; i<%d; ++i )\n", rangecnt[l] );
+    fprintf( out, "\t\tif ( uni>=unicode_ranges%s[i][0] && uni<=unicode_ranges%s[i][1] ) return( 1 );\n", lg[l], lg[l] );
+    fprintf( out, "\treturn( 0 );\n}\n" );
+
+    fprintf( out, "/* Return unicode value for a name made by unicode_rangename%s(), else -1. */\n", lg[l] );
+    fprintf( out, "static long unicode_rangecode%s(const char *name, size_t len) {\n", lg[l] );
+    fprintf( out, "\tchar buf[UN_NAMESIZE];\n\tunsigned long u;\n\tunsigned int l, v, t;\n" );
+    fprintf( out, "\tsize_t a, b, k;\n\n" );
+    fprintf( out, "\tif ( len<=16 || len>=UN_NAMESIZE ) return( -1 );\n" );
+    fprintf( out, "\tif ( strncmp(name,\"HANGUL SYLLABLE \",16)==0 ) {\n" );
+    fprintf( out, "\t\tname+=16; len-=16;\n\t\tfor ( l=0; l<19; ++l ) {\n" );
+    fprintf( out, "\t\t\tif ( (a=strlen(unicode_jamoL%s[l]))>len || strncmp(name,unicode_jamoL%s[l],a)!=0 ) continue;\n", lg[l], lg[l] );
+    fprintf( out, "\t\t\tfor ( v=0; v<21; ++v ) {\n" );
+    fprintf( out, "\t\t\t\tif ( (b=strlen(unicode_jamoV%s[v]))>len-a || strncmp(name+a,unicode_jamoV%s[v],b)!=0 ) continue;\n", lg[l], lg[l] );
+    fprintf( out, "\t\t\t\tfor ( t=0; t<28; ++t ) {\n" );
+    fprintf( out, "\t\t\t\t\tif ( strlen(unicode_jamoT%s[t])==len-a-b && strncmp(name+a+b,unicode_jamoT%s[t],len-a-b)==0 ) {\n", lg[l], lg[l] );
+    fprintf( out, "\t\t\t\t\t\tu=0xAC00+(l*21+v)*28+t;\n" );
+    fprintf( out, "\t\t\t\t\t\treturn( unicode_rangename%s(u,buf)!=NULL ? (long)(u) : -1 );\n", lg[l] );
+    fprintf( out, "\t\t\t\t\t}\n\t\t\t\t}\n\t\t\t}\n\t\t}\n\t\treturn( -1 );\n\t}\n" );
+    fprintf( out, "\tfor ( k=len; k>0 && name[k-1]!='-'; --k );\n" );
+    fprintf( out, "\tif ( k==0 || len-k<4 || len-k>5 ) return( -1 );\n" );
+    fprintf( out, "\tfor ( u=0; k<len; ++k ) {\n\t\tif ( name[k]>='0' && name[k]<='9' )\n" );
+    fprintf( out, "\t\t\tu=(u<<4)+(unsigned long)(name[k]-'0');\n" );
+    fprintf( out, "\t\telse if ( name[k]>='A' && name[k]<='F' )\n" );
+    fprintf( out, "\t\t\tu=(u<<4)+(unsigned long)(name[k]-'A'+10);\n\t\telse\n" );
+    fprintf( out, "\t\t\treturn( -1 );\n\t}\n" );
+    fprintf( out, "\tif ( unicode_rangename%s(u,buf)==NULL || strncmp(buf,name,len)!=0 || buf[len]!='\\0' ) return( -1 );\n", lg[l] );
+    fprintf( out, "\treturn( (long)(u) );\n}\n" );
     return( 1 );
 }
 
-static int dump(int is_fr) {
-    int dumpOK=0;
+static void dumpnullpage(FILE *out, const char *macro, int null2) {
+    unsigned int i;
 
-    FILE *out = fopen(is_fr ? "nameslist-fr.c":"nameslist.c","w");
-    if ( out==NULL ) {
-	fprintf( stderr, "Cannot open output file\n" );
-	return( dumpOK );
+    fprintf( out, "#define %s \\\n", macro );
+    for ( i=0; i<256; ++i ) {
+	if ( (i&7)==0 ) putc('\t',out);
+	if ( null2 && i>=0xfe )
+	    fprintf( out, "UNA(0,0,%u,%u)", nullofs[i-0xfe], nulldisplay[i-0xfe] );
+	else
+	    fprintf( out, "UNA(0,0,0,0)" );
+	fprintf( out, "%s", i==255 ? "\n" : (i&7)==7 ? ", \\\n" : ", " );
     }
-    FILE *header = fopen( is_fr ? "uninameslist-fr.h": "uninameslist.h","w");
-    if ( header==NULL ) {
-	fprintf( stderr, "Cannot open output header file\n" );
-	fclose(out);
-	return( dumpOK );
+}
+
+/* Pages a and b (uni>>8) have the same offsets for every unicode value */
+static int samepage(unsigned int a, unsigned int b) {
+    a <<= 8; b <<= 8;
+    return( memcmp(nameofs+a,nameofs+b,256*sizeof(uint32_t))==0 && \
+	    memcmp(tokofs+a,tokofs+b,256*sizeof(uint32_t))==0 && \
+	    memcmp(annotofs+a,annotofs+b,256*sizeof(uint32_t))==0 && \
+	    memcmp(displayofs+a,displayofs+b,256*sizeof(uint32_t))==0 );
+}
+
+static int dumparrays(FILE *out, FILE *header, int is_fr ) {
+    unsigned int i,j,k,u,npages,pagemap[0x1100],pagefirst[0x1100];
+    int l;
+    char *prefix = "una";
+    char *upper = "UNA";
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    if ( !dumppool(out,is_fr) || !dumptokens(out,is_fr) || !dumpnamebuf(out,is_fr) )
+	return( 0 );
+
+    fprintf( out, "struct unicode_annotofs {\n\tuint32_t annot;\n" );
+    fprintf( out, "#ifdef WANTANNOTDISPLAY\n\tuint32_t display;\n#endif\n};\n\n" );
+    fprintf( out, "/* Each page with data is defined by the macro %s%s_XX_XX, which lists */\n", upper, lg[l] );
+    fprintf( out, "/* UNA(name,tokens,annot,display) offsets. unicode_namepages%s[], */\n", lg[l] );
+    fprintf( out, "/* unicode_annotpages%s[] and UnicodeNameAnnot%s[] use the macros, each */\n", lg[l], lg[l] );
+    fprintf( out, "/* with its own UNA(). display is into unicode_display%s[], 0 if same */\n", lg[l] );
+    fprintf( out, "/* as annot. */\n" );
+    fprintf( out, "#ifdef WANTNAMETOKENS\n#define UNN(n,t)\tt\n" );
+    fprintf( out, "#else\n#define UNN(n,t)\tn\n#endif\n\n" );
+    dumpnullpage(out,lg[l][0] ? "UNAFR_NULL" : "UNA_NULL",0);
+    dumpnullpage(out,lg[l][0] ? "UNAFR_NULL2" : "UNA_NULL2",1);
+    putc('\n',out);
+
+    /* Page 0 is empty, page 1 only has the U+?FFFE and U+?FFFF annotations */
+    /* at the end of each plane, then each different page with data. */
+    npages = 2;
+    for ( i=0; i<0x1100; ++i ) {
+	k = emptyplane(is_fr,i>>8) ? ((i&0xff)==0xff ? 2 : 0) : (unsigned int)(pagekind(is_fr,i>>8,i&0xff));
+	pagemap[i] = k==2 ? 1 : 0;
+	if ( k!=1 )
+    continue;
+	fprintf( out, "#define %s%s_%02X_%02X \\\n", upper, lg[l], i>>8, i&0xff );
+	for ( k=0; k<256; ++k ) {
+	    u = (i<<8) + k;
+	    fprintf( out, "/* %04X */ UNA(%u,%u,%u,%u)%s\n", u, nameofs[u], tokofs[u], annotofs[u], displayofs[u], k!=255 ? ", \\" : "" );
+	}
+	putc('\n',out);
+	for ( j=2; j<npages && !samepage(pagefirst[j],i); ++j );
+	if ( j==npages )
+	    pagefirst[npages++] = i;
+	pagemap[i] = j;
     }
 
-    if ( dumpinit(out,header,is_fr) && dumpblock(out,header,is_fr) && \
-	 dumparrays(out,header,is_fr) && dumpend(header,is_fr) && \
-	 fflush(out)==0 && fflush(header)==0 )
-	dumpOK=1;
-    fclose(out); fclose(header);
-    return( dumpOK );
+    fprintf( out, "/* unicode_pagemap%s[uni>>8] is the page of uni in unicode_namepages%s[] */\n", lg[l], lg[l] );
+    fprintf( out, "/* and unicode_annotpages%s[], where pages that are the same are kept */\n", lg[l] );
+    fprintf( out, "/* once. These have no pointers so there is nothing to relocate when the */\n" );
+    fprintf( out, "/* library is loaded. Names and annotations are apart, so that looking */\n" );
+    fprintf( out, "/* up names only reads 4 bytes for each unicode value. */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint16_t unicode_pagemap%s[0x1100] = {", lg[l] );
+    for ( i=0; i<0x1100; ++i )
+	fprintf( out, "%s%u%s", (i&15) ? " " : "\n\t", pagemap[i], i+1<0x1100 ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+    for ( k=0; k<2; ++k ) {
+	if ( k==0 ) {
+	    fprintf( out, "#define UNA(n,t,a,d)\tUNN(n,t)\n" );
+	    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_namepages%s[%u][256] = {\n", lg[l], npages );
+	} else {
+	    fprintf( out, "#undef UNA\n#ifdef WANTANNOTDISPLAY\n#define UNA(n,t,a,d)\t{ a, d }\n" );
+	    fprintf( out, "#else\n#define UNA(n,t,a,d)\t{ a }\n#endif\n" );
+	    fprintf( out, "UN_DLL_LOCAL UN_COLD\nstatic const struct unicode_annotofs unicode_annotpages%s[%u][256] = {\n", lg[l], npages );
+	}
+	fprintf( out, "\t{ %s%s_NULL },\n\t{ %s%s_NULL2 }%s\n", upper, lg[l], upper, lg[l], npages>2 ? "," : "" );
+	for ( j=2; j<npages; ++j )
+	    fprintf( out, "\t{ %s%s_%02X_%02X }%s\n", upper, lg[l], pagefirst[j]>>8, pagefirst[j]&0xff, j+1<npages ? "," : "" );
+	fprintf( out, "};\n\n" );
+    }
+    fprintf( out, "#define UN_NAMEOFS%s(u)\t(unicode_namepages%s[unicode_pagemap%s[(u)>>8]][(u)&0xff])\n", lg[l], lg[l], lg[l] );
+    fprintf( out, "#define UN_ANNOTOFS%s(u)\t(unicode_annotpages%s[unicode_pagemap%s[(u)>>8]][(u)&0xff])\n\n", lg[l], lg[l], lg[l] );
+
+    /* ASCII names for the text decoders, without going through the pages */
+    fprintf( out, "#ifndef WANTNAMETOKENS\n" );
+    fprintf( out, "/* Name offsets of 0..127 in unicode_namepool%s[], 0 for the controls, so */\n", lg[l] );
+    fprintf( out, "/* the text decoders look up ASCII with one load and no page walk. */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_asciiname%s[128] = {", lg[l] );
+    for ( k=0; k<128; ++k )
+	fprintf( out, "%s%u%s", (k&7) ? " " : "\n\t", nameofs[k], k+1<128 ? "," : "" );
+    fprintf( out, "\n};\n#define UN_ASCIINAME%s(c)\t(unicode_asciiname%s[c]!=0 ? unicode_namepool%s+unicode_asciiname%s[c] : (const char *)(0))\n#endif\n\n",
+	     lg[l], lg[l], lg[l], lg[l] );
+
+    /* The older pointer based UnicodeNameAnnot[] compatibility pages */
+    fprintf( out, "#ifdef WANTNAMEANNOT\n" );
+    fprintf( out, "/* Older programs may index UnicodeNameAnnot[] directly. This costs a */\n" );
+    fprintf( out, "/* relocation for every string, so it is only built if requested.   */\n" );
+    fprintf( out, "#undef UNA\n#define UNA(n,t,a,d)\t{ (n) ? unicode_namepool%s+(n) : (const char *)(0), (a) ? unicode_annotpool%s+(a) : (const char *)(0) }\n\n", lg[l], lg[l] );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot nullarray%s[] = { %s%s_NULL };\n", lg[l], upper, lg[l] );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot nullarray2%s[] = { %s%s_NULL2 };\n\n", lg[l], upper, lg[l] );
+    for ( i=0; i<17; ++i ) if ( !emptyplane(is_fr,i) ) {
+	for ( j=0; j<256; ++j ) if ( pagekind(is_fr,i,j)==1 )
+	    fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot %s%s_%02X_%02X[] = { %s%s_%02X_%02X };\n",
+		     prefix, lg[l], i, j, upper, lg[l], i, j );
+    }
+    putc('\n',out);
+
+    fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot * const nullnullarray%s[] = {\n", lg[l] );
+    for ( j=0; j<256; ++j )
+	fprintf( out, "%snullarray%s%s%s", (j&7) ? " " : "\t", j==255 ? "2" : "", lg[l],
+		 j==255 ? "\n" : (j&7)==7 ? ",\n" : "," );
+    fprintf( out, "};\n\n" );
+
+    for ( i=0; i<17; ++i ) {	/* For each plane */
+	if ( emptyplane(is_fr,i) )
+    continue;		/* Empty plane */
+	fprintf( out, "UN_DLL_LOCAL\nstatic const struct unicode_nameannot * const %s%s_%02X[] = {\n", prefix, lg[l], i );
+	for ( j=0; j<256; ++j ) {
+	    k = (unsigned int)(pagekind(is_fr,i,j));
+	    if ( k==0 )
+		fprintf( out, "\tnullarray%s%s\n", lg[l], j!=255?",":"" );
+	    else if ( k==2 )
+		fprintf( out, "\tnullarray2%s\n", lg[l] );
+	    else
+		fprintf( out, "\t%s%s_%02X_%02X%s\n", prefix, lg[l], i, j, j!=255?",":"" );
+	}
+	fprintf( out, "};\n\n" );
+    }
+
+    fprintf( out, "UN_DLL_EXPORT\nconst struct unicode_nameannot * const *const UnicodeNameAnnot%s[] = {\n", lg[l] );
+    for ( i=0; i<0x20; ++i ) {	/* For each plane */
+	if ( i>=17 || emptyplane(is_fr,i) )
+	    fprintf( out, "\tnullnullarray%s%s\n", lg[l], i!=0x20-1?",":"" );
+	else
+	    fprintf( out, "\t%s%s_%02X,\n", prefix, lg[l], i );
+    }
+    fprintf( out, "};\n#endif\n\n" );
+
+    fprintf( header, "\n/* Only available if built using './configure --enable-nameannot' */\n" );
+    fprintf( header, "extern const struct unicode_nameannot * const *const UnicodeNameAnnot%s[];\n", lg[l] );
+
+    fprintf( out, "/* Return name of this unicode value from its offset o, decoding into buf */\n" );
+    fprintf( out, "/* (UN_NAMESIZE) if the names are kept as tokens. o==0 has no name. */\n" );
+    fprintf( out, "static const char *unicode_namefrom%s(uint32_t o, char *buf) {\n", lg[l] );
+    fprintf( out, "\tif ( o==0 ) return( NULL );\n#ifdef WANTNAMETOKENS\n" );
+    fprintf( out, "\treturn( unicode_namedecode%s(o,buf) );\n#else\n", lg[l] );
+    fprintf( out, "\t(void)(buf);\n\treturn( unicode_namepool%s+o );\n#endif\n}\n\n", lg[l] );
+    fprintf( out, "static const char *unicode_nameget%s(unsigned long uni, char *buf) {\n", lg[l] );
+    fprintf( out, "\tuint32_t o;\n\n\tif ( uni>=0x110000 ) return( NULL );\n" );
+    fprintf( out, "\to=UN_NAMEOFS%s(uni);\n", lg[l] );
+    if ( rangecnt[l]>0 )
+	fprintf( out, "\tif ( o==0 ) return( unicode_rangename%s(uni,buf) );\n", lg[l] );
+    fprintf( out, "\treturn( unicode_namefrom%s(o,buf) );\n}\n\n", lg[l] );
+
+    fprintf( out, "/* Make the name of uni, which has offset o, at *used in the arena if it is */\n" );
+    fprintf( out, "/* not in the pool. Return unicode_namemark%s if made, NULL if uni has no */\n", lg[l] );
+    fprintf( out, "/* name, or set *err and return NULL if there is no memory. */\n" );
+    fprintf( out, "static const char *unicode_namearenaadd%s(unsigned long uni, uint32_t o, size_t *used, int *err) {\n", lg[l] );
+    fprintf( out, "\tchar *pt;\n\tsize_t n;\n\n" );
+    if ( rangecnt[l]>0 )
+	fprintf( out, "\tif ( o==0 && !unicode_inrange%s(uni) ) return( NULL );\n", lg[l] );
+    else
+	fprintf( out, "\tif ( o==0 ) return( NULL );\n" );
+    fprintf( out, "\tif ( unicode_namearenasize%s-*used<UN_NAMESIZE ) {\n", lg[l] );
+    fprintf( out, "\t\tn=unicode_namearenasize%s<64*UN_NAMESIZE ? 64*UN_NAMESIZE : 2*unicode_namearenasize%s;\n", lg[l], lg[l] );
+    fprintf( out, "\t\tif ( (pt=(char *)(realloc(unicode_namearena%s,n)))==NULL ) {\n", lg[l] );
+    fprintf( out, "\t\t\t*err=1;\n\t\t\treturn( NULL );\n\t\t}\n" );
+    fprintf( out, "\t\tunicode_namearena%s=pt;\n\t\tunicode_namearenasize%s=n;\n\t}\n", lg[l], lg[l] );
+    fprintf( out, "\tpt=unicode_namearena%s+*used;\n", lg[l] );
+    fprintf( out, "\tif ( unicode_nameget%s(uni,pt)!=pt ) return( NULL );\n", lg[l] );
+    fprintf( out, "\t*used+=strlen(pt)+1;\n\treturn( unicode_namemark%s );\n}\n\n", lg[l] );
+    fprintf( out, "/* Return the name of uni in the pool, or NULL if none. Names that are */\n" );
+    fprintf( out, "/* made go in the arena if used is not NULL, see unicode_namearenaadd%s(). */\n", lg[l] );
+    fprintf( out, "static UN_INLINE const char *unicode_namenext%s(unsigned long uni, size_t *used, int *err) {\n", lg[l] );
+    fprintf( out, "\tuint32_t o;\n\n" );
+    fprintf( out, "\tif ( uni>=0x110000 ) return( NULL );\n\to=UN_NAMEOFS%s(uni);\n", lg[l] );
+    fprintf( out, "#ifndef WANTNAMETOKENS\n\tif ( o!=0 ) return( unicode_namepool%s+o );\n#endif\n", lg[l] );
+    fprintf( out, "\treturn( used==NULL ? NULL : unicode_namearenaadd%s(uni,o,used,err) );\n}\n\n", lg[l] );
+
+    /* Added functions available in libuninameslist version 0.3 and higher. */
+    fprintf( out, "/* Retrieve a pointer to the name of a Unicode codepoint. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_name%s(unsigned long uni) {\n", lg[l] );
+    fprintf( out, "\treturn( unicode_nameget%s(uni,unicode_namebuf%s) );\n}\n\n", lg[l], lg[l] );
+    fprintf( out, "/* Retrieve a pointer to annotation details of a Unicode codepoint. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_annot%s(unsigned long uni) {\n", lg[l] );
+    fprintf( out, "\tuint32_t o=0;\n\n" );
+    fprintf( out, "\tif ( uni<0x110000 )\n" );
+    fprintf( out, "\t\to=UN_ANNOTOFS%s(uni).annot;\n", lg[l] );
+    fprintf( out, "\treturn( o ? unicode_annotpool%s+o : NULL );\n}\n\n", lg[l] );
+    fprintf( out, "#ifdef WANTANNOTDISPLAY\n" );
+    fprintf( out, "/* Return the annotation with its markup replaced by symbols, in UTF-8. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "const char *uniNamesList_annotDisplay%s(unsigned long uni) {\n", lg[l] );
+    fprintf( out, "\tconst struct unicode_annotofs *p;\n\n" );
+    fprintf( out, "\tif ( uni>=0x110000 ) return( NULL );\n" );
+    fprintf( out, "\tp=&UN_ANNOTOFS%s(uni);\n", lg[l] );
+    fprintf( out, "\tif ( p->display ) return( unicode_display%s+p->display );\n", lg[l] );
+    fprintf( out, "\treturn( p->annot ? unicode_annotpool%s+p->annot : NULL );\n}\n#else\n", lg[l] );
+    fprintf( out, "/* Longest annotation with its markup replaced by symbols, plus one */\n" );
+    fprintf( out, "#define UN_DISPLAYSIZE%s\t%u\n\n", lg[l], (unsigned int)(maxdisplay+1) );
+    fprintf( out, "static UN_THREAD char unicode_displaybuf%s[UN_DISPLAYSIZE%s];\n\n", lg[l], lg[l] );
+    fprintf( out, "/* Return the annotation with its markup replaced by symbols, in UTF-8, */\n" );
+    fprintf( out, "/* made in a buffer for this thread. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "const char *uniNamesList_annotDisplay%s(unsigned long uni) {\n", lg[l] );
+    fprintf( out, "\tstatic const char marks[] = \"*%%x~:#\";\n" );
+    fprintf( out, "\tstatic const char symbols[6][4] = {\n" );
+    fprintf( out, "\t\t\"\\xE2\\x80\\xA2\", \"\\xE2\\x80\\xBB\", \"\\xE2\\x86\\x92\", \"\\xE2\\x81\\x93\", \"\\xE2\\x89\\xA1\", \"\\xE2\\x89\\x88\"\n" );
+    fprintf( out, "\t};\n\tconst char *pt, *m;\n\tchar *bpt=unicode_displaybuf%s;\n", lg[l] );
+    fprintf( out, "\tint bol=1;\n\n" );
+    fprintf( out, "\tif ( (pt=uniNamesList_annot%s(uni))==NULL ) return( NULL );\n", lg[l] );
+    fprintf( out, "\tfor ( ; *pt!='\\0'; ++pt ) {\n" );
+    fprintf( out, "\t\tif ( bol && pt[0]=='\\t' && pt[1]!='\\0' && (m=strchr(marks,pt[1]))!=NULL ) {\n" );
+    fprintf( out, "\t\t\t*bpt++='\\t';\n\t\t\tmemcpy(bpt,symbols[m-marks],3);\n" );
+    fprintf( out, "\t\t\tbpt+=3; ++pt; bol=0;\n\t\t\tcontinue;\n\t\t}\n" );
+    fprintf( out, "\t\tbol = *pt=='\\n';\n\t\t*bpt++=*pt;\n\t}\n\t*bpt='\\0';\n" );
+    fprintf( out, "\treturn( unicode_displaybuf%s );\n}\n#endif\n\n", lg[l] );
+    if ( is_fr==0 ) {
+	fprintf( out, "/* Same as above using lang. Return English if language has no annotation. */\n" );
+	fprintf( out, "UN_DLL_EXPORT\nconst char *uniNamesList_annotDisplayAlt(unsigned long uni, unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tconst char *pt=NULL;\n\n\tif ( pack!=NULL && pack->annotDisplay!=NULL )\n" );
+	fprintf( out, "\t\tpt=pack->annotDisplay(uni);\n" );
+	fprintf( out, "\tif ( pt==NULL )\n\t\tpt=uniNamesList_annotDisplay(uni);\n\treturn( pt );\n}\n\n" );
+    }
+    fprintf( out, "/* Copy name into buf, cut to size-1 characters. Return name length, */\n" );
+    fprintf( out, "/* like snprintf(), or -1 if there is no name for this unicode value. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_nameBuf%s(unsigned long uni, char *buf, size_t size) {\n", lg[l] );
+    fprintf( out, "\tchar tmp[UN_NAMESIZE];\n\tconst char *pt;\n\tsize_t len, k;\n\n" );
+    fprintf( out, "\tif ( buf!=NULL && size>0 ) *buf='\\0';\n" );
+    fprintf( out, "\tif ( (pt=unicode_nameget%s(uni,tmp))==NULL ) return( -1 );\n", lg[l] );
+    fprintf( out, "\tlen=strlen(pt);\n\tif ( buf!=NULL && size>0 ) {\n" );
+    fprintf( out, "\t\tk = len<size ? len : size-1;\n\t\tmemcpy(buf,pt,k);\n\t\tbuf[k]='\\0';\n\t}\n" );
+    fprintf( out, "\treturn( (int)(len) );\n}\n\n" );
+
+    free(nameofs); free(annotofs); free(tokofs); free(displayofs);
+    nameofs = annotofs = tokofs = displayofs = NULL;
+    return( 1 );
+}
+
+/* uniNamesList_codepoint() uses a minimal perfect hash built here, so */
+/* the library has nothing to build at runtime. Keys are first hashed */
+/* into buckets (seed 0), then each bucket gets a displacement d that */
+/* sends all of its keys to free slots (seed d), or if d<0, the bucket */
+/* holds one key that lives in slot -d-1. namehash() is also dumped.  */
+struct hashkey {
+    const char *key;
+    size_t len;
+    uint32_t code, bucket;
+};
+
+static uint32_t namehash(uint32_t d, const char *pt, size_t len) {
+    uint32_t h = 0x811c9dc5u ^ (d * 0x9e3779b9u);
+
+    while ( len-- > 0 ) {
+	h ^= (uint32_t)((unsigned char)(*pt++));
+	h *= 0x01000193u;
+    }
+    h ^= h >> 16; h *= 0x85ebca6bu; h ^= h >> 13;
+    return( h );
+}
+
+static int cmphashkey(const void *a, const void *b) {
+    const struct hashkey *ka = (const struct hashkey *)(a);
+    const struct hashkey *kb = (const struct hashkey *)(b);
+    int c;
+
+    if ( ka->bucket!=kb->bucket )
+	return( ka->bucket<kb->bucket ? -1 : 1 );
+    if ( (c=strcmp(ka->key,kb->key))!=0 )
+	return( c );
+    return( ka->code<kb->code ? -1 : ka->code>kb->code );
+}
+
+struct hashbucket {
+    uint32_t bucket, first, cnt;
+};
+
+static int cmphashbucket(const void *a, const void *b) {
+    const struct hashbucket *ba = (const struct hashbucket *)(a);
+    const struct hashbucket *bb = (const struct hashbucket *)(b);
+
+    if ( ba->cnt!=bb->cnt )
+	return( ba->cnt>bb->cnt ? -1 : 1 );
+    return( ba->bucket<bb->bucket ? -1 : ba->bucket>bb->bucket );
+}
+
+/* Sort keys into buckets, drop duplicate keys, and fill disp[nb] plus */
+/* slot[*n] (the code found at each slot). Returns 0 if out of memory. */
+static int buildhash(struct hashkey *keys, uint32_t *n, uint32_t nb,
+		     int32_t *disp, uint32_t *slot) {
+    struct hashbucket *buckets;
+    uint32_t i, j, k, m, d, pos[64];
+    char *used;
+
+    for ( i=0; i<*n; ++i )
+	keys[i].bucket = namehash(0,keys[i].key,keys[i].len) % nb;
+    qsort(keys,*n,sizeof(struct hashkey),cmphashkey);
+    for ( i=j=0; i<*n; ++i ) {
+	if ( j>0 && keys[j-1].bucket==keys[i].bucket && strcmp(keys[j-1].key,keys[i].key)==0 ) {
+	    fprintf( stderr, "Duplicate name \"%s\" for %04X, keeping %04X\n",
+		     keys[i].key, keys[i].code, keys[j-1].code );
+	    continue;
+	}
+	keys[j++] = keys[i];
+    }
+    m = *n = j;
+
+    if ( (buckets=(struct hashbucket *)(calloc(nb,sizeof(struct hashbucket))))==NULL )
+	return( 0 );
+    if ( (used=(char *)(calloc(m+1,1)))==NULL ) {
+	free(buckets);
+	return( 0 );
+    }
+    for ( i=0; i<nb; ++i ) buckets[i].bucket = i;
+    for ( i=m; i>0; --i ) {
+	buckets[keys[i-1].bucket].first = i-1;
+	buckets[keys[i-1].bucket].cnt++;
+    }
+    qsort(buckets,nb,sizeof(struct hashbucket),cmphashbucket);
+
+    for ( i=0; i<nb; ++i ) {
+	disp[buckets[i].bucket] = 0;
+	if ( buckets[i].cnt>1 ) {
+	    if ( buckets[i].cnt>sizeof(pos)/sizeof(pos[0]) ) goto errorbuildhash;
+	    for ( d=1; d<0x7fffffff; ++d ) {
+		for ( j=0; j<buckets[i].cnt; ++j ) {
+		    pos[j] = namehash(d,keys[buckets[i].first+j].key,keys[buckets[i].first+j].len) % m;
+		    if ( used[pos[j]] ) break;
+		    for ( k=0; k<j && pos[k]!=pos[j]; ++k );
+		    if ( k<j ) break;
+		}
+		if ( j==buckets[i].cnt ) break;
+	    }
+	    if ( d==0x7fffffff ) goto errorbuildhash;
+	    for ( j=0; j<buckets[i].cnt; ++j ) {
+		used[pos[j]] = 1;
+		slot[pos[j]] = keys[buckets[i].first+j].code;
+	    }
+	    disp[buckets[i].bucket] = (int32_t)(d);
+	} else if ( buckets[i].cnt==1 ) {
+	    for ( k=0; used[k]; ++k );
+	    used[k] = 1;
+	    slot[k] = keys[buckets[i].first].code;
+	    disp[buckets[i].bucket] = -(int32_t)(k)-1;
+	}
+    }
+    free(used); free(buckets);
+    return( 1 );
+
+errorbuildhash:
+    fprintf( stderr, "Cannot build perfect hash\n" );
+    free(used); free(buckets);
+    return( 0 );
+}
+
+static void dumphashfunc(FILE *out) {
+    fprintf( out, "static uint32_t unicode_namehash(uint32_t d, const char *pt, size_t len) {\n" );
+    fprintf( out, "\tuint32_t h = 0x811c9dc5u ^ (d * 0x9e3779b9u);\n\n" );
+    fprintf( out, "\twhile ( len-- > 0 ) {\n" );
+    fprintf( out, "\t\th ^= (uint32_t)((unsigned char)(*pt++));\n" );
+    fprintf( out, "\t\th *= 0x01000193u;\n\t}\n" );
+    fprintf( out, "\th ^= h >> 16; h *= 0x85ebca6bu; h ^= h >> 13;\n" );
+    fprintf( out, "\treturn( h );\n}\n\n" );
+}
+
+static void dumpuint32s(FILE *out, const uint32_t *v, uint32_t n) {
+    uint32_t i;
+
+    for ( i=0; i<n; ++i )
+	fprintf( out, "%s0x%04X%s", (i&7) ? " " : "\n\t", v[i], i+1<n ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+}
+
+static void dumpint32s(FILE *out, const int32_t *v, uint32_t n) {
+    uint32_t i;
+
+    for ( i=0; i<n; ++i )
+	fprintf( out, "%s%d%s", (i&7) ? " " : "\n\t", v[i], i+1<n ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+}
+
+static int dumpnamehash(FILE *out, int is_fr) {
+    struct hashkey *keys;
+    int32_t *disp;
+    uint32_t *slot, a_char, n, nb;
+    int l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    for ( a_char=n=0; a_char<0x110000; ++a_char )
+	if ( uninames[l][a_char]!=NULL ) ++n;
+    nb = n/4+1;
+    keys = (struct hashkey *)(malloc((n+1)*sizeof(struct hashkey)));
+    disp = (int32_t *)(malloc(nb*sizeof(int32_t)));
+    slot = (uint32_t *)(malloc((n+1)*sizeof(uint32_t)));
+    if ( keys==NULL || disp==NULL || slot==NULL ) {
+	fprintf( stderr, "Out of memory\n" );
+	free(keys); free(disp); free(slot);
+	return( 0 );
+    }
+    for ( a_char=n=0; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL ) {
+	keys[n].key = uninames[l][a_char];
+	keys[n].len = strlen(uninames[l][a_char]);
+	keys[n++].code = a_char;
+    }
+    if ( n==0 ) {
+	fprintf( stderr, "No names found\n" );
+	free(keys); free(disp); free(slot);
+	return( 0 );
+    }
+    if ( !buildhash(keys,&n,nb,disp,slot) ) {
+	free(keys); free(disp); free(slot);
+	return( 0 );
+    }
+
+    fprintf( out, "/* Minimal perfect hash of %u names, used by uniNamesList_codepoint%s() */\n", n, lg[l] );
+    dumphashfunc(out);
+    fprintf( out, "UN_DLL_LOCAL\nstatic const int32_t unicode_namedisp%s[%u] = {", lg[l], nb );
+    dumpint32s(out,disp,nb);
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_namecode%s[%u] = {", lg[l], n );
+    dumpuint32s(out,slot,n);
+
+    fprintf( out, "/* Return unicode value for this character name (-1 if not found). */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_codepointLen%s(const char *name, size_t len) {\n", lg[l] );
+    fprintf( out, "\tint32_t d;\n\tuint32_t h;\n\tconst char *pt;\n\tchar tmp[UN_NAMESIZE];\n\n" );
+    fprintf( out, "\tif ( name==NULL || len==0 ) return( -1 );\n" );
+    fprintf( out, "\td = unicode_namedisp%s[unicode_namehash(0,name,len)%%%uu];\n", lg[l], nb );
+    fprintf( out, "\tif ( d<0 )\n\t\th = (uint32_t)(-d-1);\n" );
+    fprintf( out, "\telse\n\t\th = unicode_namehash((uint32_t)(d),name,len)%%%uu;\n", n );
+    fprintf( out, "\tpt = unicode_nameget%s(unicode_namecode%s[h],tmp);\n", lg[l], lg[l] );
+    if ( rangecnt[l]>0 )
+	fprintf( out, "\tif ( pt==NULL || strncmp(pt,name,len)!=0 || pt[len]!='\\0' )\n\t\treturn( unicode_rangecode%s(name,len) );\n", lg[l] );
+    else
+	fprintf( out, "\tif ( pt==NULL || strncmp(pt,name,len)!=0 || pt[len]!='\\0' )\n\t\treturn( -1 );\n" );
+    fprintf( out, "\treturn( (long)(unicode_namecode%s[h]) );\n}\n\n", lg[l] );
+    fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_codepoint%s(const char *name) {\n", lg[l] );
+    fprintf( out, "\tif ( name==NULL ) return( -1 );\n" );
+    fprintf( out, "\treturn( uniNamesList_codepointLen%s(name,strlen(name)) );\n}\n\n", lg[l] );
+
+    free(keys); free(disp); free(slot);
+    return( 1 );
+}
+
+/* uniNamesList_codepointLoose() uses the loose matching rule UAX44-LM2: */
+/* ignore case, spaces, '_' and medial hyphens (a '-' between two letters */
+/* or digits), except the '-' in U+1180 HANGUL JUNGSEONG O-E. Such names */
+/* would have the same key as another name, so they keep their hyphens. */
+static int loosealnum(int c) {
+    return( (c>='A' && c<='Z') || (c>='a' && c<='z') || (c>='0' && c<='9') || c>=0x80 );
+}
+
+/* Make the loose key of name in key, which has room for strlen(name)+1 */
+static size_t loosekey(const char *name, int keep, char *key) {
+    size_t i, k, len=strlen(name);
+    int c;
+
+    for ( i=k=0; i<len; ++i ) {
+	c = (unsigned char)(name[i]);
+	if ( c==' ' || c=='_' || (c>='\t' && c<='\r') )
+    continue;
+	if ( c=='-' && !keep && i>0 && i+1<len && loosealnum((unsigned char)(name[i-1])) && \
+	     loosealnum((unsigned char)(name[i+1])) )
+    continue;
+	if ( c>='a' && c<='z' ) c += 'A'-'a';
+	key[k++] = (char)(c);
+    }
+    key[k] = '\0';
+    return( k );
+}
+
+static int cmploosekey(const void *a, const void *b) {
+    const struct hashkey *ka = (const struct hashkey *)(a);
+    const struct hashkey *kb = (const struct hashkey *)(b);
+    int c;
+
+    if ( (c=strcmp(ka->key,kb->key))!=0 )
+	return( c );
+    return( ka->code<kb->code ? -1 : ka->code>kb->code );
+}
+
+static int dumploosehash(FILE *out, int is_fr) {
+    struct hashkey *keys, *sorted;
+    int32_t *disp;
+    uint32_t *slot, a_char, i, j, n, nb;
+    size_t size;
+    char *arena, *pt;
+    int l, ok=0;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    for ( a_char=n=0, size=0; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL ) {
+	size += strlen(uninames[l][a_char])+1;
+	++n;
+    }
+    nb = n/4+1;
+    keys = (struct hashkey *)(malloc((n+1)*sizeof(struct hashkey)));
+    sorted = (struct hashkey *)(malloc((n+1)*sizeof(struct hashkey)));
+    disp = (int32_t *)(malloc(nb*sizeof(int32_t)));
+    slot = (uint32_t *)(malloc((n+1)*sizeof(uint32_t)));
+    arena = (char *)(malloc(size+1));
+    if ( keys==NULL || sorted==NULL || disp==NULL || slot==NULL || arena==NULL )
+	goto errorloosehash;
+    for ( a_char=n=0, pt=arena; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL ) {
+	keys[n].key = pt;
+	keys[n].len = loosekey(uninames[l][a_char],0,pt);
+	keys[n++].code = a_char;
+	pt += strlen(uninames[l][a_char])+1;
+    }
+    /* Names with the same key keep their medial hyphens */
+    memcpy(sorted,keys,n*sizeof(struct hashkey));
+    qsort(sorted,n,sizeof(struct hashkey),cmploosekey);
+    for ( i=0; i+1<n; ++i ) if ( strcmp(sorted[i].key,sorted[i+1].key)==0 ) {
+	for ( j=0; j<n; ++j ) if ( keys[j].code==sorted[i].code || keys[j].code==sorted[i+1].code ) {
+	    if ( strchr(uninames[l][keys[j].code],'-')==NULL )
+	continue;
+	    keys[j].len = loosekey(uninames[l][keys[j].code],1,arena+(keys[j].key-arena));
+	    fprintf( stdout, "%s loose key of U+%04X keeps its hyphens\n", is_fr ? "French" : "English", keys[j].code );
+	}
+    }
+    if ( !buildhash(keys,&n,nb,disp,slot) )
+	goto errorloosehash;
+
+    fprintf( out, "/* Minimal perfect hash of %u loose names (UAX44-LM2), for uniNamesList_codepointLoose%s() */\n", n, lg[l] );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const int32_t unicode_loosedisp%s[%u] = {", lg[l], nb );
+    dumpint32s(out,disp,nb);
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_loosecode%s[%u] = {", lg[l], n );
+    dumpuint32s(out,slot,n);
+
+    fprintf( out, "#define UN_LOOSEALNUM(c)\t(((c)>='A' && (c)<='Z') || ((c)>='a' && (c)<='z') || ((c)>='0' && (c)<='9') || ((c)&0x80))\n" );
+    fprintf( out, "\n" );
+    fprintf( out, "/* Make the loose key of name (len characters) in key, without case, spaces, */\n" );
+    fprintf( out, "/* '_' or medial hyphens (a '-' between letters or digits) unless keep is set. */\n" );
+    fprintf( out, "/* Return key length (0 if too long), and count medial hyphens in *hyphens. */\n" );
+    fprintf( out, "static size_t unicode_loosekey(const char *name, size_t len, char *key, int keep, int *hyphens) {\n" );
+    fprintf( out, "\tsize_t i, k;\n\tint c;\n\n" );
+    fprintf( out, "\t*hyphens=0;\n\tfor ( i=k=0; i<len; ++i ) {\n" );
+    fprintf( out, "\t\tc=*(const unsigned char *)(name+i);\n" );
+    fprintf( out, "\t\tif ( c==' ' || c=='_' || (c>='\\t' && c<='\\r') ) continue;\n" );
+    fprintf( out, "\t\tif ( c=='-' && i>0 && i+1<len && UN_LOOSEALNUM(name[i-1]) && UN_LOOSEALNUM(name[i+1]) ) {\n" );
+    fprintf( out, "\t\t\t++*hyphens;\n\t\t\tif ( !keep ) continue;\n\t\t}\n" );
+    fprintf( out, "\t\tif ( k+1>=UN_NAMESIZE ) return( 0 );\n" );
+    fprintf( out, "\t\tkey[k++]=(char)(UN_FOLD(c));\n\t}\n\tkey[k]='\\0';\n\treturn( k );\n" );
+    fprintf( out, "}\n\n" );
+    if ( rangecnt[l]>0 ) {
+	fprintf( out, "/* Loose keys of the names made from the code, see unicode_rangefixed%s[]. */\n", lg[l] );
+	fprintf( out, "static long unicode_rangeloose%s(const char *key, size_t klen) {\n", lg[l] );
+	fprintf( out, "\tstatic const char loose[3][20] = { \"HANGULSYLLABLE\", \"CJKUNIFIEDIDEOGRAPH\", \"TANGUTIDEOGRAPH\" };\n" );
+	fprintf( out, "\tchar buf[UN_NAMESIZE];\n\tsize_t i, n, f;\n\n" );
+	fprintf( out, "\tfor ( i=0; i<3; ++i ) {\n" );
+	fprintf( out, "\t\tn=strlen(loose[i]); f=strlen(unicode_rangefixed%s[i]);\n", lg[l] );
+	fprintf( out, "\t\tif ( klen>n && f+klen-n<UN_NAMESIZE && memcmp(key,loose[i],n)==0 ) {\n" );
+	fprintf( out, "\t\t\tmemcpy(buf,unicode_rangefixed%s[i],f);\n", lg[l] );
+	fprintf( out, "\t\t\tmemcpy(buf+f,key+n,klen-n);\n" );
+	fprintf( out, "\t\t\treturn( unicode_rangecode%s(buf,f+klen-n) );\n\t\t}\n\t}\n", lg[l] );
+	fprintf( out, "\treturn( -1 );\n}\n\n" );
+    }
+    fprintf( out, "/* Return unicode value for name using the loose matching rule UAX44-LM2, */\n" );
+    fprintf( out, "/* which ignores case, spaces, '_' and medial hyphens. -1 if not found. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_codepointLoose%s(const char *name) {\n", lg[l] );
+    fprintf( out, "\tchar key[UN_NAMESIZE], nkey[UN_NAMESIZE], tmp[UN_NAMESIZE];\n" );
+    fprintf( out, "\tconst char *pt;\n\tsize_t len, klen;\n\tint32_t d;\n\tuint32_t h;\n" );
+    fprintf( out, "\tint keep, hyphens, nh;\n\n" );
+    fprintf( out, "\tif ( name==NULL ) return( -1 );\n\tlen=strlen(name);\n" );
+    fprintf( out, "\t/* Names that would have the same key keep their medial hyphens, */\n" );
+    fprintf( out, "\t/* like U+1180 HANGUL JUNGSEONG O-E, so try with hyphens first. */\n" );
+    fprintf( out, "\tfor ( keep=1; keep>=0; --keep ) {\n" );
+    fprintf( out, "\t\tif ( (klen=unicode_loosekey(name,len,key,keep,&hyphens))==0 ) return( -1 );\n" );
+    fprintf( out, "\t\tif ( keep && hyphens==0 ) continue;\n" );
+    fprintf( out, "\t\td=unicode_loosedisp%s[unicode_namehash(0,key,klen)%%%uu];\n", lg[l], nb );
+    fprintf( out, "\t\th = d<0 ? (uint32_t)(-d-1) : unicode_namehash((uint32_t)(d),key,klen)%%%uu;\n", n );
+    fprintf( out, "\t\tif ( (pt=unicode_nameget%s(unicode_loosecode%s[h],tmp))!=NULL && \\\n", lg[l], lg[l] );
+    fprintf( out, "\t\t     unicode_loosekey(pt,strlen(pt),nkey,keep,&nh)==klen && memcmp(nkey,key,klen)==0 )\n" );
+    fprintf( out, "\t\t\treturn( (long)(unicode_loosecode%s[h]) );\n\t}\n", lg[l] );
+    if ( rangecnt[l]>0 )
+	fprintf( out, "\treturn( unicode_rangeloose%s(key,klen) );\n}\n\n", lg[l] );
+    else
+	fprintf( out, "\treturn( -1 );\n}\n\n" );
+    ok = 1;
+
+errorloosehash:
+    if ( !ok ) fprintf( stderr, "Cannot make loose name keys\n" );
+    free(keys); free(sorted); free(disp); free(slot); free(arena);
+    return( ok );
+}
+
+static int dumpbatch(FILE *out, int is_fr) {
+    int l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    /* Look several entries ahead so that the table rows are in cache when used */
+    fprintf( out, "#if defined(__GNUC__) || defined(__clang__)\n" );
+    fprintf( out, "#define UN_PREFETCH(p) __builtin_prefetch(p)\n#else\n" );
+    fprintf( out, "#define UN_PREFETCH(p) ((void)(p))\n#endif\n" );
+    fprintf( out, "#define UN_PREFETCH_AHEAD 8\n\n" );
+
+    fprintf( out, "/* Fill names[]/annots[]/blocks[] for count unicode values (0=ok, -1=error). */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_nameBatch%s(const uint32_t *uni, size_t count, const char **names) {\n", lg[l] );
+    fprintf( out, "\tsize_t i, k, used=0;\n\tuint32_t u;\n\tint err=0;\n\n" );
+    fprintf( out, "\tif ( count>0 && (uni==NULL || names==NULL) ) return( -1 );\n" );
+    fprintf( out, "\tfor ( i=0; i<count; ++i ) {\n" );
+    fprintf( out, "\t\tif ( i+UN_PREFETCH_AHEAD<count && (u=uni[i+UN_PREFETCH_AHEAD])<0x110000 )\n" );
+    fprintf( out, "\t\t\tUN_PREFETCH(&UN_NAMEOFS%s(u));\n", lg[l] );
+    fprintf( out, "\t\tnames[i] = unicode_namenext%s(uni[i],&used,&err);\n\t}\n", lg[l] );
+    fprintf( out, "\t/* The arena is done growing, so point at the names made in it */\n" );
+    fprintf( out, "\tfor ( i=0, k=0; k<used && i<count; ++i )\n" );
+    fprintf( out, "\t\tif ( names[i]==unicode_namemark%s ) {\n", lg[l] );
+    fprintf( out, "\t\t\tnames[i]=unicode_namearena%s+k;\n\t\t\tk+=strlen(names[i])+1;\n\t\t}\n", lg[l] );
+    fprintf( out, "\treturn( err ? -1 : 0 );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_annotBatch%s(const uint32_t *uni, size_t count, const char **annots) {\n", lg[l] );
+    fprintf( out, "\tsize_t i;\n\tuint32_t u, o;\n\n" );
+    fprintf( out, "\tif ( count>0 && (uni==NULL || annots==NULL) ) return( -1 );\n" );
+    fprintf( out, "\tfor ( i=0; i<count; ++i ) {\n" );
+    fprintf( out, "\t\tif ( i+UN_PREFETCH_AHEAD<count && (u=uni[i+UN_PREFETCH_AHEAD])<0x110000 )\n" );
+    fprintf( out, "\t\t\tUN_PREFETCH(&UN_ANNOTOFS%s(u));\n", lg[l] );
+    fprintf( out, "\t\to=0;\n\t\tif ( (u=uni[i])<0x110000 )\n" );
+    fprintf( out, "\t\t\to=UN_ANNOTOFS%s(u).annot;\n", lg[l] );
+    fprintf( out, "\t\tannots[i] = o ? unicode_annotpool%s+o : NULL;\n\t}\n\treturn( 0 );\n}\n\n", lg[l] );
+    fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_blockNumberBatch%s(const uint32_t *uni, size_t count, int *blocks) {\n", lg[l] );
+    fprintf( out, "\tsize_t i;\n\tuint32_t u;\n\n" );
+    fprintf( out, "\tif ( count>0 && (uni==NULL || blocks==NULL) ) return( -1 );\n" );
+    fprintf( out, "\tfor ( i=0; i<count; ++i ) {\n" );
+    fprintf( out, "\t\tif ( i+UN_PREFETCH_AHEAD<count && (u=uni[i+UN_PREFETCH_AHEAD])<0x110000 )\n" );
+    fprintf( out, "\t\t\tUN_PREFETCH(&unicode_blockpage%s[u>>8]);\n", lg[l] );
+    fprintf( out, "\t\tblocks[i] = uniNamesList_blockNumber%s(uni[i]);\n\t}\n\treturn( 0 );\n}\n\n", lg[l] );
+
+    if ( is_fr==0 ) {
+	fprintf( out, "/* Same as above using lang. Return English if language has no information. */\n" );
+	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_nameBatchAlt(const uint32_t *uni, size_t count, unsigned int lang, const char **names) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tsize_t i, k, used=0;\n\tint err=0;\n\n\tif ( pack!=NULL && pack->nameBatch!=NULL ) {\n" );
+	fprintf( out, "\t\tif ( pack->nameBatch(uni,count,names)<0 ) return( -1 );\n" );
+	fprintf( out, "\t\tfor ( i=0; i<count; ++i )\n" );
+	fprintf( out, "\t\t\tif ( names[i]==NULL ) names[i]=unicode_namenext(uni[i],&used,&err);\n" );
+	fprintf( out, "\t\tfor ( i=0, k=0; k<used && i<count; ++i )\n" );
+	fprintf( out, "\t\t\tif ( names[i]==unicode_namemark ) {\n" );
+	fprintf( out, "\t\t\t\tnames[i]=unicode_namearena+k;\n\t\t\t\tk+=strlen(names[i])+1;\n\t\t\t}\n" );
+	fprintf( out, "\t\treturn( err ? -1 : 0 );\n\t}\n" );
+	fprintf( out, "\treturn( uniNamesList_nameBatch(uni,count,names) );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_annotBatchAlt(const uint32_t *uni, size_t count, unsigned int lang, const char **annots) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tsize_t i;\n\n\tif ( pack!=NULL && pack->annotBatch!=NULL ) {\n" );
+	fprintf( out, "\t\tif ( pack->annotBatch(uni,count,annots)<0 ) return( -1 );\n" );
+	fprintf( out, "\t\tfor ( i=0; i<count; ++i )\n" );
+	fprintf( out, "\t\t\tif ( annots[i]==NULL ) annots[i]=uniNamesList_annot(uni[i]);\n" );
+	fprintf( out, "\t\treturn( 0 );\n\t}\n" );
+	fprintf( out, "\treturn( uniNamesList_annotBatch(uni,count,annots) );\n}\n\n" );
+	fprintf( out, "/* Blocklists won't sync if they are different versions. */\n" );
+	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_blockNumberBatchAlt(const uint32_t *uni, size_t count, unsigned int lang, int *blocks) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->blockNumberBatch!=NULL )\n" );
+	fprintf( out, "\t\treturn( pack->blockNumberBatch(uni,count,blocks) );\n" );
+	fprintf( out, "\treturn( uniNamesList_blockNumberBatch(uni,count,blocks) );\n}\n\n" );
+    }
+    return( 1 );
+}
+
+/* Enumerating names should not look at every empty unicode value, so */
+/* dump a bitmap of the named ones. Each page of 256 has a bit saying it */
+/* has names, and one saying all are named. Pages with some named have */
+/* rows of bits, found by counting the bits of such pages before them. */
+static int dumpnamed(FILE *out, int is_fr) {
+    static PERTHREAD uint32_t bits[0x1100][8];
+    uint32_t page[0x1100/32], full[0x1100/32], rank[0x1100/32], planes;
+    unsigned int i, j, k, n, np;
+    long a_char;
+    int l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    memset(page,0,sizeof(page)); memset(full,0,sizeof(full));
+    for ( i=np=0, planes=0; i<0x1100; ++i ) {
+	if ( (i&31)==0 )
+	    rank[i>>5] = np;
+	memset(bits[np],0,sizeof(bits[0]));
+	for ( j=n=0; j<256; ++j ) {
+	    a_char = (long)((i<<8)+j);
+	    if ( uninames[l][a_char]==NULL ) {
+		for ( k=0; k<(unsigned int)(rangecnt[l]); ++k )
+		    if ( a_char>=ranges[l][k].start && a_char<=ranges[l][k].end )
+		break;
+		if ( k==(unsigned int)(rangecnt[l]) )
+	    continue;
+	    }
+	    bits[np][j>>5] |= 1u<<(j&31);
+	    ++n;
+	}
+	if ( n==0 )
+    continue;
+	page[i>>5] |= 1u<<(i&31);
+	planes |= 1u<<(i>>8);
+	if ( n==256 )
+	    full[i>>5] |= 1u<<(i&31);
+	else
+	    ++np;
+    }
+
+    fprintf( out, "/* Unicode values with names. Bits of unicode_namedpage%s[] are set for */\n", lg[l] );
+    fprintf( out, "/* pages of 256 with names, of unicode_namedfull%s[] for pages all named. */\n", lg[l] );
+    fprintf( out, "/* The bits of other pages are in unicode_namedbits%s[], at a row counted */\n", lg[l] );
+    fprintf( out, "/* from unicode_namedrank%s[] and the page bits before it in its word. */\n", lg[l] );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_namedplanes%s = 0x%05X;\n\n", lg[l], planes );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_namedpage%s[%d] = {", lg[l], 0x1100/32 );
+    for ( i=0; i<0x1100/32; ++i )
+	fprintf( out, "%s0x%08X%s", (i&7) ? " " : "\n\t", page[i], i+1<0x1100/32 ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_namedfull%s[%d] = {", lg[l], 0x1100/32 );
+    for ( i=0; i<0x1100/32; ++i )
+	fprintf( out, "%s0x%08X%s", (i&7) ? " " : "\n\t", full[i], i+1<0x1100/32 ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const %s unicode_namedrank%s[%d] = {", np<256 ? "uint8_t" : "uint16_t", lg[l], 0x1100/32 );
+    for ( i=0; i<0x1100/32; ++i )
+	fprintf( out, "%s%u%s", (i&15) ? " " : "\n\t", rank[i], i+1<0x1100/32 ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_namedbits%s[%u][8] = {\n", lg[l], np>0 ? np : 1 );
+    for ( k=0; k<np || k==0; ++k ) {
+	fprintf( out, "\t{" );
+	for ( j=0; j<8; ++j )
+	    fprintf( out, " 0x%08X%s", k<np ? bits[k][j] : 0, j!=7 ? "," : "" );
+	fprintf( out, " }%s\n", k+1<np ? "," : "" );
+    }
+    fprintf( out, "};\n\n" );
+
+    fprintf( out, "/* Return the first unicode value from uni to end with a name, or -1. */\n" );
+    fprintf( out, "/* Empty planes, and up to 32 empty pages, are skipped in one step. */\n" );
+    fprintf( out, "static long unicode_nextnamed%s(unsigned long uni, unsigned long end) {\n", lg[l] );
+    fprintf( out, "\tunsigned long p;\n\tuint32_t w, b;\n\tunsigned int i, r;\n\n" );
+    fprintf( out, "\tif ( end>0x10FFFF ) end=0x10FFFF;\n" );
+    fprintf( out, "\twhile ( uni<=end ) {\n" );
+    fprintf( out, "\t\tif ( ((unicode_namedplanes%s>>(uni>>16))&1)==0 ) {\n", lg[l] );
+    fprintf( out, "\t\t\tuni=((uni>>16)+1)<<16;\n\t\t\tcontinue;\n\t\t}\n" );
+    fprintf( out, "\t\tp=uni>>8;\n" );
+    fprintf( out, "\t\tif ( (w=unicode_namedpage%s[p>>5]&(0xFFFFFFFFu<<(p&31)))==0 ) {\n", lg[l] );
+    fprintf( out, "\t\t\tuni=((p>>5)+1)<<13;\n\t\t\tcontinue;\n\t\t}\n" );
+    fprintf( out, "\t\tif ( (w&(1u<<(p&31)))==0 ) {\n" );
+    fprintf( out, "\t\t\tp=(p&~31ul)+(unsigned long)(UN_LOWBIT(w));\n\t\t\tuni=p<<8;\n\t\t}\n" );
+    fprintf( out, "\t\tif ( (unicode_namedfull%s[p>>5]>>(p&31))&1 )\n", lg[l] );
+    fprintf( out, "\t\t\treturn( uni<=end ? (long)(uni) : -1 );\n" );
+    fprintf( out, "\t\tw=unicode_namedpage%s[p>>5]&~unicode_namedfull%s[p>>5];\n", lg[l], lg[l] );
+    fprintf( out, "\t\tr=unicode_namedrank%s[p>>5]+(unsigned int)(UN_POPCOUNT(w&((1u<<(p&31))-1u)));\n", lg[l] );
+    fprintf( out, "\t\tb=unicode_namedbits%s[r][(uni>>5)&7]&(0xFFFFFFFFu<<(uni&31));\n", lg[l] );
+    fprintf( out, "\t\tfor ( i=(uni>>5)&7; b==0 && i<7; )\n" );
+    fprintf( out, "\t\t\tb=unicode_namedbits%s[r][++i];\n", lg[l] );
+    fprintf( out, "\t\tif ( b!=0 ) {\n" );
+    fprintf( out, "\t\t\tuni=(p<<8)+(i<<5)+(unsigned long)(UN_LOWBIT(b));\n" );
+    fprintf( out, "\t\t\treturn( uni<=end ? (long)(uni) : -1 );\n\t\t}\n" );
+    fprintf( out, "\t\tuni=(p+1)<<8;\n\t}\n\treturn( -1 );\n}\n\n" );
+
+    fprintf( out, "/* Return the first unicode value from uni on with a name, or -1 if none. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_nextNamed%s(unsigned long uni) {\n", lg[l] );
+    fprintf( out, "\treturn( unicode_nextnamed%s(uni,0x10FFFF) );\n}\n\n", lg[l] );
+    fprintf( out, "/* Same, only looking in this block. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_nextNamedBlock%s(unsigned long uni, int uniBlock) {\n", lg[l] );
+    fprintf( out, "\tif ( uniBlock<0 || uniBlock>=%s )\n\t\treturn( -1 );\n", lgb[l] );
+    fprintf( out, "\tif ( uni<(unsigned long)(UnicodeBlock%s[uniBlock].start) )\n", lg[l] );
+    fprintf( out, "\t\tuni=(unsigned long)(UnicodeBlock%s[uniBlock].start);\n", lg[l] );
+    fprintf( out, "\treturn( unicode_nextnamed%s(uni,(unsigned long)(UnicodeBlock%s[uniBlock].end)) );\n}\n\n", lg[l], lg[l] );
+    fprintf( out, "/* Same, only looking in this plane (0 to 16). */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_nextNamedPlane%s(unsigned long uni, unsigned int plane) {\n", lg[l] );
+    fprintf( out, "\tif ( plane>16 )\n\t\treturn( -1 );\n" );
+    fprintf( out, "\tif ( uni<((unsigned long)(plane)<<16) )\n\t\tuni=(unsigned long)(plane)<<16;\n" );
+    fprintf( out, "\treturn( unicode_nextnamed%s(uni,((unsigned long)(plane)<<16)+0xFFFF) );\n}\n\n", lg[l] );
+    if ( is_fr==0 ) {
+	fprintf( out, "/* Same using lang. Names missing in lang are English, so take either. */\n" );
+	fprintf( out, "UN_DLL_EXPORT\nlong uniNamesList_nextNamedAlt(unsigned long uni, unsigned int lang) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n" );
+	fprintf( out, "\tlong u, v;\n\n\tu=uniNamesList_nextNamed(uni);\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->nextNamed!=NULL && (v=pack->nextNamed(uni))>=0 && (u<0 || v<u) )\n" );
+	fprintf( out, "\t\tu=v;\n\treturn( u );\n}\n\n" );
+    }
+    return( 1 );
+}
+
+static int dumptext(FILE *out, int is_fr) {
+    char ab[64];
+    long a_char;
+    int b, l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    /* The ASCII fast path uses one block number if all of 0..127 are in it */
+    b = findblock(l,0);
+    for ( a_char=1; a_char<0x80 && findblock(l,a_char)==b; ++a_char );
+    if ( a_char==0x80 )
+	sprintf( ab, "%d", b );
+    else
+	sprintf( ab, "uniNamesList_blockNumber%s(c)", lg[l] );
+
+    fprintf( out, "/* Decode a UTF-8 buffer, and look up each character, filling up to max out[] */\n" );
+    fprintf( out, "/* entries. Return count of entries, *used is set to bytes consumed from buf. */\n" );
+    fprintf( out, "/* Malformed sequences are returned as U+FFFD, one per maximal subpart. A */\n" );
+    fprintf( out, "/* sequence cut at the end of buf is left for the next call, unless end is */\n" );
+    fprintf( out, "/* set, when it is U+FFFD too. Offsets are relative to buf. Names that are */\n" );
+    fprintf( out, "/* made go in the arena, from *made on, or are left NULL if made is NULL. */\n" );
+    fprintf( out, "static size_t unicode_textutf8%s(const char *buf, size_t len, struct unicode_text *out, size_t max, size_t *used, int end, size_t *made) {\n", lg[l] );
+    fprintf( out, "\tconst unsigned char *s=(const unsigned char *)(buf);\n" );
+    fprintf( out, "\tsize_t i=0, n=0, j, k;\n\tuint64_t w;\n\tuint32_t c, u, lo, hi;\n" );
+    fprintf( out, "\tint need, err=0;\n\n" );
+    fprintf( out, "\tif ( buf==NULL || out==NULL ) len=max=0;\n" );
+    fprintf( out, "\tif ( max>len ) max=len;\n" );
+    fprintf( out, "\twhile ( i<len && n<max ) {\n" );
+    fprintf( out, "\t\t/* ASCII fast path, 8 bytes at a time with names from a table */\n" );
+    fprintf( out, "\t\twhile ( i+8<=len && n+8<=max ) {\n\t\t\tmemcpy(&w,s+i,8);\n" );
+    fprintf( out, "\t\t\tif ( w&UINT64_C(0x8080808080808080) ) break;\n" );
+    fprintf( out, "\t\t\tfor ( j=0; j<8; ++j ) {\n\t\t\t\tc=s[i+j];\n" );
+    fprintf( out, "\t\t\t\tout[n+j].offset=i+j;\n\t\t\t\tout[n+j].uni=c;\n" );
+    fprintf( out, "\t\t\t\tout[n+j].block=%s;\n", ab );
+    fprintf( out, "#ifdef WANTNAMETOKENS\n\t\t\t\tout[n+j].name=unicode_namenext%s(c,made,&err);\n", lg[l] );
+    fprintf( out, "#else\n\t\t\t\tout[n+j].name=UN_ASCIINAME%s(c);\n#endif\n", lg[l] );
+    fprintf( out, "\t\t\t}\n\t\t\ti+=8; n+=8;\n\t\t}\n\t\tif ( i>=len || n>=max ) break;\n" );
+    fprintf( out, "\t\tout[n].offset=i;\n\t\tc=s[i++];\n" );
+    fprintf( out, "\t\tu=0xfffd; need=0; lo=0x80; hi=0xbf;\n\t\tif ( c<0x80 )\n\t\t\tu=c;\n" );
+    fprintf( out, "\t\telse if ( c>=0xc2 && c<=0xdf ) {\n\t\t\tneed=1; u=c&0x1f;\n" );
+    fprintf( out, "\t\t} else if ( c>=0xe0 && c<=0xef ) {\n\t\t\tneed=2; u=c&0x0f;\n" );
+    fprintf( out, "\t\t\tif ( c==0xe0 ) lo=0xa0; else if ( c==0xed ) hi=0x9f;\n" );
+    fprintf( out, "\t\t} else if ( c>=0xf0 && c<=0xf4 ) {\n\t\t\tneed=3; u=c&0x07;\n" );
+    fprintf( out, "\t\t\tif ( c==0xf0 ) lo=0x90; else if ( c==0xf4 ) hi=0x8f;\n\t\t}\n" );
+    fprintf( out, "\t\tfor ( ; need>0; --need ) {\n" );
+    fprintf( out, "\t\t\tif ( i>=len || s[i]<lo || s[i]>hi ) {\n\t\t\t\tu=0xfffd;\n" );
+    fprintf( out, "\t\t\t\tbreak;\n\t\t\t}\n\t\t\tu=(u<<6)|(uint32_t)(s[i++]&0x3f);\n" );
+    fprintf( out, "\t\t\tlo=0x80; hi=0xbf;\n\t\t}\n" );
+    fprintf( out, "\t\tif ( need>0 && i>=len && !end ) {\n" );
+    fprintf( out, "\t\t\ti=out[n].offset;\n\t\t\tbreak;\n\t\t}\n\t\tout[n].uni=u;\n" );
+    fprintf( out, "\t\tout[n].block=uniNamesList_blockNumber%s(u);\n", lg[l] );
+    fprintf( out, "\t\tout[n].name=unicode_namenext%s(u,made,&err);\n\t\t++n;\n", lg[l] );
+    fprintf( out, "\t}\n\tif ( made!=NULL )\n" );
+    fprintf( out, "\t\tfor ( j=0, k=0; k<*made && j<n; ++j )\n" );
+    fprintf( out, "\t\t\tif ( out[j].name==unicode_namemark%s ) {\n", lg[l] );
+    fprintf( out, "\t\t\t\tout[j].name=unicode_namearena%s+k;\n\t\t\t\tk+=strlen(out[j].name)+1;\n\t\t\t}\n", lg[l] );
+    fprintf( out, "\tif ( used!=NULL ) *used=i;\n\treturn( n );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "size_t uniNamesList_textUTF8%s(const char *buf, size_t len, struct unicode_text *out, size_t max, size_t *used) {\n", lg[l] );
+    fprintf( out, "\tsize_t made=0;\n\n" );
+    fprintf( out, "\treturn( unicode_textutf8%s(buf,len,out,max,used,0,&made) );\n}\n\n", lg[l] );
+    fprintf( out, "/* Same as above for UTF-16 in native byte order, offsets count 16bit units. */\n" );
+    fprintf( out, "/* Unpaired surrogates are returned as U+FFFD, and a high surrogate at the */\n" );
+    fprintf( out, "/* end of buf is left for the next call unless end is set. */\n" );
+    fprintf( out, "static size_t unicode_textutf16%s(const uint16_t *buf, size_t len, struct unicode_text *out, size_t max, size_t *used, int end, size_t *made) {\n", lg[l] );
+    fprintf( out, "\tsize_t i=0, n=0, j, k;\n\tuint64_t w;\n\tuint32_t c, u;\n" );
+    fprintf( out, "\tint err=0;\n\n" );
+    fprintf( out, "\tif ( buf==NULL || out==NULL ) len=max=0;\n" );
+    fprintf( out, "\tif ( max>len ) max=len;\n" );
+    fprintf( out, "\twhile ( i<len && n<max ) {\n" );
+    fprintf( out, "\t\t/* ASCII fast path, 4 units at a time with names from a table */\n" );
+    fprintf( out, "\t\twhile ( i+4<=len && n+4<=max ) {\n\t\t\tmemcpy(&w,buf+i,8);\n" );
+    fprintf( out, "\t\t\tif ( w&UINT64_C(0xff80ff80ff80ff80) ) break;\n" );
+    fprintf( out, "\t\t\tfor ( j=0; j<4; ++j ) {\n\t\t\t\tc=buf[i+j];\n" );
+    fprintf( out, "\t\t\t\tout[n+j].offset=i+j;\n\t\t\t\tout[n+j].uni=c;\n" );
+    fprintf( out, "\t\t\t\tout[n+j].block=%s;\n", ab );
+    fprintf( out, "#ifdef WANTNAMETOKENS\n\t\t\t\tout[n+j].name=unicode_namenext%s(c,made,&err);\n", lg[l] );
+    fprintf( out, "#else\n\t\t\t\tout[n+j].name=UN_ASCIINAME%s(c);\n#endif\n", lg[l] );
+    fprintf( out, "\t\t\t}\n\t\t\ti+=4; n+=4;\n\t\t}\n\t\tif ( i>=len || n>=max ) break;\n" );
+    fprintf( out, "\t\tout[n].offset=i;\n\t\tu=c=buf[i++];\n" );
+    fprintf( out, "\t\tif ( c>=0xd800 && c<=0xdfff ) {\n" );
+    fprintf( out, "\t\t\tif ( c<0xdc00 && i>=len && !end ) {\n\t\t\t\t--i;\n\t\t\t\tbreak;\n\t\t\t}\n" );
+    fprintf( out, "\t\t\tu=0xfffd;\n" );
+    fprintf( out, "\t\t\tif ( c<0xdc00 && i<len && buf[i]>=0xdc00 && buf[i]<=0xdfff )\n" );
+    fprintf( out, "\t\t\t\tu=0x10000+((c-0xd800)<<10)+(uint32_t)(buf[i++]-0xdc00);\n\t\t}\n" );
+    fprintf( out, "\t\tout[n].uni=u;\n\t\tout[n].block=uniNamesList_blockNumber%s(u);\n", lg[l] );
+    fprintf( out, "\t\tout[n].name=unicode_namenext%s(u,made,&err);\n\t\t++n;\n", lg[l] );
+    fprintf( out, "\t}\n\tif ( made!=NULL )\n" );
+    fprintf( out, "\t\tfor ( j=0, k=0; k<*made && j<n; ++j )\n" );
+    fprintf( out, "\t\t\tif ( out[j].name==unicode_namemark%s ) {\n", lg[l] );
+    fprintf( out, "\t\t\t\tout[j].name=unicode_namearena%s+k;\n\t\t\t\tk+=strlen(out[j].name)+1;\n\t\t\t}\n", lg[l] );
+    fprintf( out, "\tif ( used!=NULL ) *used=i;\n\treturn( n );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "size_t uniNamesList_textUTF16%s(const uint16_t *buf, size_t len, struct unicode_text *out, size_t max, size_t *used) {\n", lg[l] );
+    fprintf( out, "\tsize_t made=0;\n\n" );
+    fprintf( out, "\treturn( unicode_textutf16%s(buf,len,out,max,used,0,&made) );\n}\n\n", lg[l] );
+    fprintf( out, "/* Decode all of buf and call fn() for each character, in order. A cut */\n" );
+    fprintf( out, "/* sequence at the end of buf is U+FFFD, as the text ends there. Return 0 */\n" );
+    fprintf( out, "/* when done, -1 if error, or the non-zero value returned by fn() to stop. */\n" );
+    fprintf( out, "/* Names that are made are put in a buffer on the stack, so t->name is */\n" );
+    fprintf( out, "/* only valid until fn() returns, and fn() may call other lookups. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "int uniNamesList_textUTF8Call%s(const char *buf, size_t len, int (*fn)(const struct unicode_text *t, void *data), void *data) {\n", lg[l] );
+    fprintf( out, "\tstruct unicode_text t[64];\n\tchar nb[UN_NAMESIZE];\n\tsize_t i, j, n, used;\n\tint ret;\n\n" );
+    fprintf( out, "\tif ( buf==NULL || fn==NULL ) return( -1 );\n" );
+    fprintf( out, "\tfor ( i=0; i<len; i+=used ) {\n" );
+    fprintf( out, "\t\tn=unicode_textutf8%s(buf+i,len-i,t,64,&used,1,NULL);\n", lg[l] );
+    fprintf( out, "\t\tif ( used==0 ) return( -1 );\n\t\tfor ( j=0; j<n; ++j ) {\n" );
+    fprintf( out, "\t\t\tt[j].offset+=i;\n" );
+    fprintf( out, "\t\t\tif ( t[j].name==NULL ) t[j].name=unicode_nameget%s(t[j].uni,nb);\n", lg[l] );
+    fprintf( out, "\t\t\tif ( (ret=fn(&t[j],data))!=0 ) return( ret );\n\t\t}\n\t}\n" );
+    fprintf( out, "\treturn( 0 );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "int uniNamesList_textUTF16Call%s(const uint16_t *buf, size_t len, int (*fn)(const struct unicode_text *t, void *data), void *data) {\n", lg[l] );
+    fprintf( out, "\tstruct unicode_text t[64];\n\tchar nb[UN_NAMESIZE];\n\tsize_t i, j, n, used;\n\tint ret;\n\n" );
+    fprintf( out, "\tif ( buf==NULL || fn==NULL ) return( -1 );\n" );
+    fprintf( out, "\tfor ( i=0; i<len; i+=used ) {\n" );
+    fprintf( out, "\t\tn=unicode_textutf16%s(buf+i,len-i,t,64,&used,1,NULL);\n", lg[l] );
+    fprintf( out, "\t\tif ( used==0 ) return( -1 );\n\t\tfor ( j=0; j<n; ++j ) {\n" );
+    fprintf( out, "\t\t\tt[j].offset+=i;\n" );
+    fprintf( out, "\t\t\tif ( t[j].name==NULL ) t[j].name=unicode_nameget%s(t[j].uni,nb);\n", lg[l] );
+    fprintf( out, "\t\t\tif ( (ret=fn(&t[j],data))!=0 ) return( ret );\n\t\t}\n\t}\n" );
+    fprintf( out, "\treturn( 0 );\n}\n" );
+    return( 1 );
+}
+
+/* uniNamesList_search() uses the different words in names, sorted without */
+/* ASCII case, and for each word the names that use it, as indexes into a */
+/* list of all named unicode values. The library only looks at the names */
+/* that use the rarest word of the query. */
+static int foldcmp(const struct lexword *wa, const struct lexword *wb) {
+    size_t i;
+    int c, d;
+
+    for ( i=0; i<wa->len && i<wb->len; ++i ) {
+	c = (unsigned char)(wa->word[i]); if ( c>='a' && c<='z' ) c += 'A'-'a';
+	d = (unsigned char)(wb->word[i]); if ( d>='a' && d<='z' ) d += 'A'-'a';
+	if ( c!=d )
+	    return( c<d ? -1 : 1 );
+    }
+    return( wa->len<wb->len ? -1 : wa->len>wb->len ? 1 : 0 );
+}
+
+static int cmpsearchword(const void *a, const void *b) {
+    const struct lexword *wa = (const struct lexword *)(a);
+    const struct lexword *wb = (const struct lexword *)(b);
+    int c;
+
+    if ( (c=foldcmp(wa,wb))!=0 )
+	return( c );
+    return( wa->code<wb->code ? -1 : wa->code>wb->code );
+}
+
+static void dumpfolded(const struct lexword *w, FILE *out) {
+    size_t i;
+    int c;
+
+    for ( i=0; i<w->len; ++i ) {
+	c = (unsigned char)(w->word[i]); if ( c>='a' && c<='z' ) c += 'A'-'a';
+	putc(c,out);
+    }
+}
+
+static int dumpsearch(FILE *out, int is_fr) {
+    struct lexword *w, *byname, key[128];
+    uint32_t a_char, i, n, nn, nw, np, *named, *wofs, *pofs, *post;
+    int l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    for ( a_char=n=nn=0; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL ) {
+	n += splitwords(uninames[l][a_char],key);
+	++nn;
+    }
+    w = (struct lexword *)(malloc((n+1)*sizeof(struct lexword)));
+    named = (uint32_t *)(malloc((nn+1)*sizeof(uint32_t)));
+    wofs = (uint32_t *)(malloc((n+2)*sizeof(uint32_t)));
+    pofs = (uint32_t *)(malloc((n+2)*sizeof(uint32_t)));
+    post = (uint32_t *)(malloc((n+1)*sizeof(uint32_t)));
+    byname = (struct lexword *)(malloc((nn+1)*sizeof(struct lexword)));
+    if ( w==NULL || named==NULL || wofs==NULL || pofs==NULL || post==NULL || byname==NULL ) {
+	fprintf( stderr, "Out of memory\n" );
+	free(w); free(named); free(wofs); free(pofs); free(post); free(byname);
+	return( 0 );
+    }
+    for ( a_char=n=nn=0; a_char<0x110000; ++a_char ) if ( uninames[l][a_char]!=NULL ) {
+	for ( i=splitwords(uninames[l][a_char],w+n); i>0; --i )
+	    w[n++].code = nn;
+	byname[nn].word = uninames[l][a_char];
+	byname[nn].len = strlen(uninames[l][a_char]);
+	byname[nn].code = nn;
+	named[nn++] = a_char;
+    }
+    qsort(w,n,sizeof(struct lexword),cmpsearchword);
+    qsort(byname,nn,sizeof(struct lexword),cmpsearchword);
+    for ( i=nw=np=0, wofs[0]=pofs[0]=0; i<n; ++i ) {
+	if ( i>0 && foldcmp(&w[i],&w[i-1])==0 ) {
+	    if ( w[i].code==w[i-1].code )
+    continue;
+	} else {
+	    if ( i>0 ) ++nw;
+	    wofs[nw+1] = wofs[nw]+(uint32_t)(w[i].len)+1;
+	}
+	post[np++] = w[i].code;
+	pofs[nw+1] = np;
+    }
+    if ( n>0 ) ++nw;
+
+    fprintf( out, "/* All named unicode values. unicode_sbyname%s[] below sorts them by name. */\n", lg[l] );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_snamed%s[%u] = {", lg[l], nn );
+    dumpuint32s(out,named,nn);
+    fprintf( out, "/* The %u different words in names in upper case, and the names */\n", nw );
+    fprintf( out, "/* that use each word (as indexes into unicode_snamed%s[]). */\n", lg[l] );
+    fprintf( out, "#if defined(__GNUC__)\n#pragma GCC diagnostic push\n" );
+    fprintf( out, "#pragma GCC diagnostic ignored \"-Woverlength-strings\"\n#endif\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const char unicode_swords%s[] =", lg[l] );
+    for ( i=np=0; i<n; ++i ) if ( i==0 || foldcmp(&w[i],&w[i-1])!=0 ) {
+	fprintf( out, "%s\"", (np&7) ? " " : "\n\t" );
+	dumpfolded(&w[i],out);
+	fprintf( out, "\\n\"" );
+	++np;
+    }
+    fprintf( out, ";\n" );
+    fprintf( out, "#if defined(__GNUC__)\n#pragma GCC diagnostic pop\n#endif\n\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_swordofs%s[%u] = {", lg[l], nw+1 );
+    dumpuint32s(out,wofs,nw+1);
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_spostofs%s[%u] = {", lg[l], nw+1 );
+    dumpuint32s(out,pofs,nw+1);
+    np = pofs[nw];
+    fprintf( out, "UN_DLL_LOCAL\nstatic const %s unicode_spost%s[%u] = {", nn>65536 ? "uint32_t" : "uint16_t", lg[l], np );
+    dumpuint32s(out,post,np);
+    for ( i=0; i<nn; ++i ) post[i] = byname[i].code;
+    fprintf( out, "UN_DLL_LOCAL\nstatic const %s unicode_sbyname%s[%u] = {", nn>65536 ? "uint32_t" : "uint16_t", lg[l], nn );
+    dumpuint32s(out,post,nn);
+
+    fprintf( stdout, "%s search index: %u words, %u bytes\n", is_fr ? "French" : "English",
+	     nw, 4*nn+wofs[nw]+8*(nw+1)+(nn>65536 ? 4 : 2)*(np+nn) );
+    free(w); free(named); free(wofs); free(pofs); free(post); free(byname);
+
+    fprintf( out, "\n#define UN_FOLD(c)\t((c)>='a' && (c)<='z' ? (c)-'a'+'A' : (c))\n\n" );
+    fprintf( out, "/* Compare up to n characters of a and b ignoring ASCII case, like strncmp(). */\n" );
+    fprintf( out, "static int unicode_foldncmp(const char *a, const char *b, size_t n) {\n" );
+    fprintf( out, "\tint c, d;\n\n" );
+    fprintf( out, "\tfor ( ; n>0; --n ) {\n" );
+    fprintf( out, "\t\tc=UN_FOLD(*(const unsigned char *)(a)); ++a;\n" );
+    fprintf( out, "\t\td=UN_FOLD(*(const unsigned char *)(b)); ++b;\n" );
+    fprintf( out, "\t\tif ( c!=d ) return( c<d ? -1 : 1 );\n\t\tif ( c=='\\0' ) break;\n" );
+    fprintf( out, "\t}\n\treturn( 0 );\n}\n\n" );
+    fprintf( out, "/* Return 1 if q (qlen characters) is found in s (slen characters). */\n" );
+    fprintf( out, "static int unicode_foldfind(const char *s, size_t slen, const char *q, size_t qlen) {\n" );
+    fprintf( out, "\tsize_t i;\n\n" );
+    fprintf( out, "\tfor ( i=0; i+qlen<=slen; ++i )\n" );
+    fprintf( out, "\t\tif ( unicode_foldncmp(s+i,q,qlen)==0 ) return( 1 );\n" );
+    fprintf( out, "\treturn( 0 );\n}\n\n" );
+    fprintf( out, "/* How a word of the query must match a word of a name. The first and last */\n" );
+    fprintf( out, "/* words of a substring may be parts of words. 0=word, 1=prefix, 2=suffix, */\n" );
+    fprintf( out, "/* 3=any part of a word. */\n" );
+    fprintf( out, "static int unicode_searchkind(int flags, int first, int last) {\n" );
+    fprintf( out, "\tif ( flags==UN_SEARCH_WORDS ) return( 0 );\n" );
+    fprintf( out, "\tif ( first && last ) return( 3 );\n\tif ( last ) return( 1 );\n" );
+    fprintf( out, "\tif ( first ) return( 2 );\n\treturn( 0 );\n}\n\n" );
+    fprintf( out, "/* Return 1 if name matches query (qlen characters) using flags. */\n" );
+    fprintf( out, "static int unicode_searchmatch(const char *name, const char *q, size_t qlen, int flags) {\n" );
+    fprintf( out, "\tsize_t i, j, k, m, n=strlen(name);\n\n" );
+    fprintf( out, "\tif ( flags==UN_SEARCH_PREFIX )\n" );
+    fprintf( out, "\t\treturn( n>=qlen && unicode_foldncmp(name,q,qlen)==0 );\n" );
+    fprintf( out, "\tif ( flags==UN_SEARCH_SUBSTRING )\n" );
+    fprintf( out, "\t\treturn( unicode_foldfind(name,n,q,qlen) );\n" );
+    fprintf( out, "\tfor ( i=0; i<qlen; i=j+1 ) {\n" );
+    fprintf( out, "\t\tfor ( j=i; j<qlen && q[j]!=' '; ++j );\n\t\tif ( j==i ) continue;\n" );
+    fprintf( out, "\t\tfor ( k=0; k<n; k=m+1 ) {\n" );
+    fprintf( out, "\t\t\tfor ( m=k; m<n && name[m]!=' '; ++m );\n" );
+    fprintf( out, "\t\t\tif ( m-k==j-i && unicode_foldncmp(name+k,q+i,j-i)==0 ) break;\n" );
+    fprintf( out, "\t\t}\n\t\tif ( k>=n ) return( 0 );\n\t}\n\treturn( 1 );\n}\n" );
+    fprintf( out, "/* Mark the names that use word i in bits[], return how many there are. */\n" );
+    fprintf( out, "static size_t unicode_searchmark%s(size_t i, uint32_t *bits) {\n", lg[l] );
+    fprintf( out, "\tuint32_t k, p;\n\n" );
+    fprintf( out, "\tif ( bits!=NULL ) for ( k=unicode_spostofs%s[i]; k<unicode_spostofs%s[i+1]; ++k ) {\n", lg[l], lg[l] );
+    fprintf( out, "\t\tp=unicode_spost%s[k];\n\t\tbits[p>>5]|=(uint32_t)(1)<<(p&31);\n\t}\n", lg[l] );
+    fprintf( out, "\treturn( unicode_spostofs%s[i+1]-unicode_spostofs%s[i] );\n}\n\n", lg[l], lg[l] );
+    fprintf( out, "/* Return how many names use the words that match q (qlen characters) as */\n" );
+    fprintf( out, "/* kind, and mark these names in bits[] if it is not NULL. */\n" );
+    fprintf( out, "static size_t unicode_searchwords%s(const char *q, size_t qlen, int kind, uint32_t *bits) {\n", lg[l] );
+    fprintf( out, "\tconst size_t nw=sizeof(unicode_swordofs%s)/sizeof(unicode_swordofs%s[0])-1;\n", lg[l], lg[l] );
+    fprintf( out, "\tsize_t lo=0, hi, mid, end, i, cost=0;\n\tconst char *pt;\n" );
+    fprintf( out, "\tchar fq[UN_NAMESIZE];\n\n" );
+    fprintf( out, "\t/* Words are kept in upper case, each one ending with '\\n' */\n" );
+    fprintf( out, "\tif ( qlen>=UN_NAMESIZE ) return( 0 );\n\tfor ( i=0; i<qlen; ++i )\n" );
+    fprintf( out, "\t\tif ( (fq[i]=(char)(UN_FOLD(*(const unsigned char *)(q+i))))=='\\n' ) return( 0 );\n" );
+    fprintf( out, "\tfq[qlen]='\\0';\n\tif ( kind<=1 ) {\n" );
+    fprintf( out, "\t\t/* Words that start with q are next to each other, q itself first */\n" );
+    fprintf( out, "\t\tfor ( hi=nw; lo<hi; ) {\n\t\t\tmid=(lo+hi)/2;\n" );
+    fprintf( out, "\t\t\tif ( strncmp(unicode_swords%s+unicode_swordofs%s[mid],fq,qlen)<0 ) lo=mid+1; else hi=mid;\n", lg[l], lg[l] );
+    fprintf( out, "\t\t}\n\t\tfor ( end=lo, hi=nw; end<hi; ) {\n\t\t\tmid=(end+hi)/2;\n" );
+    fprintf( out, "\t\t\tif ( strncmp(unicode_swords%s+unicode_swordofs%s[mid],fq,qlen)>0 ) hi=mid; else end=mid+1;\n", lg[l], lg[l] );
+    fprintf( out, "\t\t}\n\t\tif ( kind==0 && lo<end )\n" );
+    fprintf( out, "\t\t\tend = unicode_swordofs%s[lo+1]-unicode_swordofs%s[lo]-1==qlen ? lo+1 : lo;\n", lg[l], lg[l] );
+    fprintf( out, "\t\tfor ( i=lo; i<end; ++i )\n" );
+    fprintf( out, "\t\t\tcost+=unicode_searchmark%s(i,bits);\n\t\treturn( cost );\n\t}\n", lg[l] );
+    fprintf( out, "\tfor ( pt=unicode_swords%s; (pt=strstr(pt,fq))!=NULL; ) {\n", lg[l] );
+    fprintf( out, "\t\t/* Find which word this is in */\n" );
+    fprintf( out, "\t\tfor ( lo=0, hi=nw; lo+1<hi; ) {\n\t\t\tmid=(lo+hi)/2;\n" );
+    fprintf( out, "\t\t\tif ( unicode_swordofs%s[mid]<=(size_t)(pt-unicode_swords%s) ) lo=mid; else hi=mid;\n", lg[l], lg[l] );
+    fprintf( out, "\t\t}\n\t\tif ( kind==2 && pt[qlen]!='\\n' ) {\n\t\t\t++pt;\n" );
+    fprintf( out, "\t\t\tcontinue;\n\t\t}\n\t\tcost+=unicode_searchmark%s(lo,bits);\n", lg[l] );
+    fprintf( out, "\t\tpt=unicode_swords%s+unicode_swordofs%s[lo+1];\n\t}\n", lg[l], lg[l] );
+    fprintf( out, "\treturn( cost );\n}\n\n" );
+    if ( rangecnt[l]>0 ) {
+	fprintf( out, "/* Names made from ranges are a fixed part, then a part made from the code */\n" );
+	fprintf( out, "/* (the jamo names, or the hex value), so check the query against the fixed */\n" );
+	fprintf( out, "/* part once. Return what the made part must be: -1=nothing matches, 0=any, */\n" );
+	fprintf( out, "/* 1=start with *pat, 2=be *pat, 3=have *pat in it. */\n" );
+	fprintf( out, "static int unicode_searchvar(int k, const char *q, size_t qlen, int flags, const char **pat, size_t *plen) {\n" );
+	fprintf( out, "\tstatic const char *chars[3] = { \"ABCDEGHIJKLMNOPRSTUWY\", \"0123456789ABCDEF\", \"0123456789ABCDEF\" };\n" );
+	fprintf( out, "\tconst char *f=unicode_rangefixed%s[k];\n", lg[l] );
+	fprintf( out, "\tsize_t flen=strlen(f), lw, i, j, n, w;\n" );
+	fprintf( out, "\tint how=0;\n\n" );
+	fprintf( out, "\t*pat=NULL; *plen=0;\n\tif ( flags==UN_SEARCH_PREFIX ) {\n" );
+	fprintf( out, "\t\tif ( unicode_foldncmp(f,q,qlen<flen ? qlen : flen)!=0 ) return( -1 );\n" );
+	fprintf( out, "\t\tif ( qlen<=flen ) return( 0 );\n" );
+	fprintf( out, "\t\t*pat=q+flen; *plen=qlen-flen; how=1;\n" );
+	fprintf( out, "\t} else if ( flags==UN_SEARCH_SUBSTRING ) {\n" );
+	fprintf( out, "\t\tif ( unicode_foldfind(f,flen,q,qlen) ) return( 0 );\n" );
+	fprintf( out, "\t\t/* A space or '-' in q must be where the fixed part ends */\n" );
+	fprintf( out, "\t\tfor ( i=qlen; i>0 && q[i-1]!=f[flen-1]; --i );\n" );
+	fprintf( out, "\t\tif ( i>flen || unicode_foldncmp(f+flen-i,q,i)!=0 ) return( -1 );\n" );
+	fprintf( out, "\t\t*pat=q+i; *plen=qlen-i; how = i>0 ? 1 : 3;\n\t} else {\n" );
+	fprintf( out, "\t\t/* Each word is a word of the fixed part, or is the last word */\n" );
+	fprintf( out, "\t\tfor ( lw=flen; lw>0 && f[lw-1]!=' '; --lw );\n" );
+	fprintf( out, "\t\tfor ( i=0; i<qlen; i=j+1 ) {\n" );
+	fprintf( out, "\t\t\tfor ( j=i; j<qlen && q[j]!=' '; ++j );\n" );
+	fprintf( out, "\t\t\tif ( j==i ) continue;\n\t\t\tfor ( n=0; n<lw; n=w+1 ) {\n" );
+	fprintf( out, "\t\t\t\tfor ( w=n; f[w]!=' '; ++w );\n" );
+	fprintf( out, "\t\t\t\tif ( w-n==j-i && unicode_foldncmp(f+n,q+i,j-i)==0 ) break;\n" );
+	fprintf( out, "\t\t\t}\n\t\t\tif ( n<lw ) continue;\n" );
+	fprintf( out, "\t\t\tif ( j-i<=flen-lw || unicode_foldncmp(f+lw,q+i,flen-lw)!=0 ) return( -1 );\n" );
+	fprintf( out, "\t\t\tif ( how==2 && (*plen!=j-i-(flen-lw) || unicode_foldncmp(*pat,q+i+flen-lw,*plen)!=0) ) return( -1 );\n" );
+	fprintf( out, "\t\t\t*pat=q+i+flen-lw; *plen=j-i-(flen-lw); how=2;\n\t\t}\n\t}\n" );
+	fprintf( out, "\tif ( *plen>(k==0 ? 7 : 5) ) return( -1 );\n" );
+	fprintf( out, "\tfor ( i=n=0; i<*plen; ++i ) {\n" );
+	fprintf( out, "\t\tif ( strchr(chars[k],UN_FOLD(*(const unsigned char *)(*pat+i)))==NULL ) return( -1 );\n" );
+	fprintf( out, "\t\t/* Jamo names have one run of vowels, the name of the medial jamo */\n" );
+	fprintf( out, "\t\tif ( strchr(\"AEIOUWY\",UN_FOLD(*(const unsigned char *)(*pat+i)))!=NULL && \\\n" );
+	fprintf( out, "\t\t     (i==0 || strchr(\"AEIOUWY\",UN_FOLD(*(const unsigned char *)(*pat+i-1)))==NULL) && ++n>1 && k==0 ) return( -1 );\n" );
+	fprintf( out, "\t}\n\treturn( how );\n}\n\n" );
+	fprintf( out, "/* Return the first code from u on whose n hex digits have the plen digits */\n" );
+	fprintf( out, "/* of p somewhere in them, or 0x110000 if there is none with n digits. */\n" );
+	fprintf( out, "static unsigned long unicode_searchhex(unsigned long u, size_t n, unsigned long p, size_t plen) {\n" );
+	fprintf( out, "\tconst unsigned long mask=((unsigned long)(1)<<(4*plen))-1;\n" );
+	fprintf( out, "\tunsigned long best=0x110000, v, high;\n\tsize_t s;\n\n" );
+	fprintf( out, "\tfor ( s=0; s+plen<=n; ++s ) {\n" );
+	fprintf( out, "\t\t/* The next code with p in the digits that are s from the right */\n" );
+	fprintf( out, "\t\thigh=u>>(4*(s+plen));\n\t\tv=(u>>(4*s))&mask;\n" );
+	fprintf( out, "\t\tif ( v>p ) ++high;\n" );
+	fprintf( out, "\t\tv = v==p ? u : ((high<<(4*plen))|p)<<(4*s);\n" );
+	fprintf( out, "\t\tif ( v<best && (v>>(4*n))==0 ) best=v;\n\t}\n" );
+	fprintf( out, "\treturn( best );\n}\n\n" );
+	fprintf( out, "#ifndef UN_RANGE_VISIT\n" );
+	fprintf( out, "/* tests/call-test21.c counts the codes range searches make names for */\n" );
+	fprintf( out, "#define UN_RANGE_VISIT(u)\n#endif\n\n" );
+	fprintf( out, "/* Call fn() for each name made from range r that matches query. */\n" );
+	fprintf( out, "static int unicode_searchrange%s(size_t r, const char *q, size_t qlen, int flags, int (*fn)(unsigned long uni, const char *name, void *data), void *data) {\n", lg[l] );
+	fprintf( out, "\tconst unsigned long start=unicode_ranges%s[r][0], end=unicode_ranges%s[r][1];\n", lg[l], lg[l] );
+	fprintf( out, "\tunsigned long u, p, lo, hi;\n\tunsigned int l, v, t;\n" );
+	fprintf( out, "\tchar buf[UN_NAMESIZE], s[8];\n\tconst char *pat;\n" );
+	fprintf( out, "\tsize_t plen, i, n;\n\tint how, ret;\n\n" );
+	fprintf( out, "\tif ( (how=unicode_searchvar((int)(unicode_ranges%s[r][2]),q,qlen,flags,&pat,&plen))<0 ) return( 0 );\n", lg[l] );
+	fprintf( out, "\tif ( unicode_ranges%s[r][2]==0 ) {\n", lg[l] );
+	fprintf( out, "\t\t/* Check the jamo names of each Hangul syllable before making names */\n" );
+	fprintf( out, "\t\tfor ( l=0; l<19; ++l ) for ( v=0; v<21; ++v ) for ( t=0; t<28; ++t ) {\n" );
+	fprintf( out, "\t\t\tu=0xAC00+(l*21+v)*28+t;\n\t\t\tif ( u<start || u>end ) continue;\n" );
+	fprintf( out, "\t\t\tstrcpy(s,unicode_jamoL%s[l]); strcat(s,unicode_jamoV%s[v]); strcat(s,unicode_jamoT%s[t]);\n", lg[l], lg[l], lg[l] );
+	fprintf( out, "\t\t\tn=strlen(s);\n" );
+	fprintf( out, "\t\t\tif ( how==3 ? !unicode_foldfind(s,n,pat,plen) :\n" );
+	fprintf( out, "\t\t\t     how>0 && (n<plen || (how==2 && n!=plen) || unicode_foldncmp(s,pat,plen)!=0) ) continue;\n" );
+	fprintf( out, "\t\t\tUN_RANGE_VISIT(u);\n" );
+	fprintf( out, "\t\t\tif ( unicode_rangename%s(u,buf)!=NULL && unicode_searchmatch(buf,q,qlen,flags) && (ret=fn(u,buf,data))!=0 )\n", lg[l] );
+	fprintf( out, "\t\t\t\treturn( ret );\n\t\t}\n\t\treturn( 0 );\n\t}\n" );
+	fprintf( out, "\t/* Ideographs whose hex value starts with pat are in one or two runs, */\n" );
+	fprintf( out, "\t/* those with pat anywhere in it are stepped to by unicode_searchhex() */\n" );
+	fprintf( out, "\tfor ( n=4; n<=5; ++n ) {\n\t\tlo=start; hi=end; p=0;\n" );
+	fprintf( out, "\t\tif ( how>0 ) {\n" );
+	fprintf( out, "\t\t\tif ( plen>n || (how==2 && plen!=n) ) continue;\n" );
+	fprintf( out, "\t\t\tfor ( i=0; i<plen; ++i )\n" );
+	fprintf( out, "\t\t\t\tp=(p<<4)+(unsigned long)(pat[i]<='9' ? pat[i]-'0' : UN_FOLD(*(const unsigned char *)(pat+i))-'A'+10);\n" );
+	fprintf( out, "\t\t\tif ( how!=3 ) {\n" );
+	fprintf( out, "\t\t\t\tlo=p<<(4*(n-plen)); hi=lo+((unsigned long)(1)<<(4*(n-plen)))-1;\n" );
+	fprintf( out, "\t\t\t\tif ( lo<start ) lo=start;\n\t\t\t\tif ( hi>end ) hi=end;\n\t\t\t}\n" );
+	fprintf( out, "\t\t} else if ( n==5 )\n\t\t\tbreak;\n" );
+	fprintf( out, "\t\tif ( n==5 && lo<0x10000 ) lo=0x10000;\n" );
+	fprintf( out, "\t\tfor ( u=lo; u<=hi; ++u ) {\n" );
+	fprintf( out, "\t\t\tif ( how==3 && (u=unicode_searchhex(u,n,p,plen))>hi ) break;\n" );
+	fprintf( out, "\t\t\tUN_RANGE_VISIT(u);\n" );
+	fprintf( out, "\t\t\tif ( unicode_rangename%s(u,buf)!=NULL && unicode_searchmatch(buf,q,qlen,flags) && (ret=fn(u,buf,data))!=0 )\n", lg[l] );
+	fprintf( out, "\t\t\t\treturn( ret );\n\t\t}\n\t}\n\treturn( 0 );\n}\n\n" );
+    }
+    fprintf( out, "/* Call fn() in unicode order for each name that matches query using flags. */\n" );
+    fprintf( out, "/* Names that start with query are next to each other in unicode_sbyname%s[], */\n", lg[l] );
+    fprintf( out, "/* otherwise names must use each word of query, starting with the rarest. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "int uniNamesList_search%s(const char *query, int flags, int (*fn)(unsigned long uni, const char *name, void *data), void *data) {\n", lg[l] );
+    fprintf( out, "\tconst size_t nn=sizeof(unicode_snamed%s)/sizeof(unicode_snamed%s[0]);\n", lg[l], lg[l] );
+    fprintf( out, "\tsize_t qlen, i, j, lo, hi, mid, best=0, bestlen=0, cost, bestcost=SIZE_MAX;\n" );
+    if ( rangecnt[l]>0 )
+	fprintf( out, "\tsize_t r=0;\n" );
+    fprintf( out, "\tuint32_t *bits, *more, u;\n\tint kind, bestkind=0, ret=0;\n" );
+    fprintf( out, "\tconst char *name;\n\tchar buf[UN_NAMESIZE];\n\n" );
+    fprintf( out, "\tif ( query==NULL || fn==NULL || flags<UN_SEARCH_PREFIX || flags>UN_SEARCH_WORDS ) return( -1 );\n" );
+    fprintf( out, "\tqlen=strlen(query);\n\tfor ( i=0; i<qlen && query[i]==' '; ++i );\n" );
+    fprintf( out, "\tif ( i==qlen ) return( 0 );\n" );
+    fprintf( out, "\tif ( (bits=(uint32_t *)(calloc(nn/32+1,sizeof(uint32_t))))==NULL ) return( -1 );\n" );
+    fprintf( out, "\tif ( flags==UN_SEARCH_PREFIX ) {\n\t\tfor ( lo=0, hi=nn; lo<hi; ) {\n" );
+    fprintf( out, "\t\t\tmid=(lo+hi)/2;\n" );
+    fprintf( out, "\t\t\tif ( unicode_foldncmp(unicode_nameget%s(unicode_snamed%s[unicode_sbyname%s[mid]],buf),query,qlen)<0 ) lo=mid+1; else hi=mid;\n", lg[l], lg[l], lg[l] );
+    fprintf( out, "\t\t}\n" );
+    fprintf( out, "\t\tfor ( ; lo<nn && unicode_foldncmp(unicode_nameget%s(unicode_snamed%s[unicode_sbyname%s[lo]],buf),query,qlen)==0; ++lo )\n", lg[l], lg[l], lg[l] );
+    fprintf( out, "\t\t\tbits[unicode_sbyname%s[lo]>>5]|=(uint32_t)(1)<<(unicode_sbyname%s[lo]&31);\n", lg[l], lg[l] );
+    fprintf( out, "\t} else {\n\t\tfor ( i=0; i<qlen; i=j+1 ) {\n" );
+    fprintf( out, "\t\t\tfor ( j=i; j<qlen && query[j]!=' '; ++j );\n" );
+    fprintf( out, "\t\t\tif ( j==i ) continue;\n" );
+    fprintf( out, "\t\t\tkind=unicode_searchkind(flags,i==0,j==qlen);\n" );
+    fprintf( out, "\t\t\tif ( (cost=unicode_searchwords%s(query+i,j-i,kind,NULL))<bestcost ) {\n", lg[l] );
+    fprintf( out, "\t\t\t\tbestcost=cost; best=i; bestlen=j-i; bestkind=kind;\n\t\t\t}\n" );
+    fprintf( out, "\t\t}\n" );
+    fprintf( out, "\t\tif ( bestcost>0 && (more=(uint32_t *)(calloc(nn/32+1,sizeof(uint32_t))))==NULL ) {\n" );
+    fprintf( out, "\t\t\tfree(bits);\n\t\t\treturn( -1 );\n\t\t}\n\t\tif ( bestcost>0 ) {\n" );
+    fprintf( out, "\t\t\t/* Names must use the other words of query too */\n" );
+    fprintf( out, "\t\t\tunicode_searchwords%s(query+best,bestlen,bestkind,bits);\n", lg[l] );
+    fprintf( out, "\t\t\tfor ( i=0; i<qlen; i=j+1 ) {\n" );
+    fprintf( out, "\t\t\t\tfor ( j=i; j<qlen && query[j]!=' '; ++j );\n" );
+    fprintf( out, "\t\t\t\tif ( j==i || i==best ) continue;\n" );
+    fprintf( out, "\t\t\t\tmemset(more,0,(nn/32+1)*sizeof(uint32_t));\n" );
+    fprintf( out, "\t\t\t\tunicode_searchwords%s(query+i,j-i,unicode_searchkind(flags,i==0,j==qlen),more);\n", lg[l] );
+    fprintf( out, "\t\t\t\tfor ( lo=0; lo<=nn/32; ++lo ) bits[lo]&=more[lo];\n\t\t\t}\n" );
+    fprintf( out, "\t\t\tfree(more);\n\t\t}\n\t}\n\tfor ( i=0; i<nn && ret==0; ++i ) {\n" );
+    fprintf( out, "\t\tif ( bits[i>>5]==0 ) {\n\t\t\ti|=31;\n\t\t\tcontinue;\n\t\t}\n" );
+    fprintf( out, "\t\tif ( (bits[i>>5]&((uint32_t)(1)<<(i&31)))==0 ) continue;\n" );
+    fprintf( out, "\t\tu=unicode_snamed%s[i];\n", lg[l] );
+    if ( rangecnt[l]>0 ) {
+	fprintf( out, "\t\tfor ( ; r<sizeof(unicode_ranges%s)/sizeof(unicode_ranges%s[0]) && unicode_ranges%s[r][0]<u && ret==0; ++r )\n", lg[l], lg[l], lg[l] );
+	fprintf( out, "\t\t\tret=unicode_searchrange%s(r,query,qlen,flags,fn,data);\n", lg[l] );
+    }
+    fprintf( out, "\t\tif ( ret==0 && (name=unicode_nameget%s(u,buf))!=NULL && unicode_searchmatch(name,query,qlen,flags) )\n", lg[l] );
+    fprintf( out, "\t\t\tret=fn(u,name,data);\n\t}\n\tfree(bits);\n" );
+    if ( rangecnt[l]>0 ) {
+	fprintf( out, "\tfor ( ; r<sizeof(unicode_ranges%s)/sizeof(unicode_ranges%s[0]) && ret==0; ++r )\n", lg[l], lg[l] );
+	fprintf( out, "\t\tret=unicode_searchrange%s(r,query,qlen,flags,fn,data);\n", lg[l] );
+    }
+    fprintf( out, "\treturn( ret );\n}\n\n" );
+    if ( is_fr==0 ) {
+	fprintf( out, "/* Same as above using lang. Search English if language has no names. */\n" );
+	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_searchAlt(const char *query, int flags, unsigned int lang, int (*fn)(unsigned long uni, const char *name, void *data), void *data) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->search!=NULL )\n" );
+	fprintf( out, "\t\treturn( pack->search(query,flags,fn,data) );\n" );
+	fprintf( out, "\treturn( uniNamesList_search(query,flags,fn,data) );\n}\n\n" );
+    }
+    return( 1 );
+}
+
+static int dumpannot(FILE *out, int is_fr) {
+    int l;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    fprintf( out, "/* Parse a code of 4 to 6 upper case hex digits ending at a space or at end. */\n" );
+    fprintf( out, "/* Return the number of digits, or 0 if there is no code at s. */\n" );
+    fprintf( out, "static size_t unicode_annothex(const char *s, const char *end, uint32_t *code) {\n" );
+    fprintf( out, "\tsize_t n;\n\tuint32_t c=0;\n\n" );
+    fprintf( out, "\tfor ( n=0; s+n<end && n<7; ++n ) {\n" );
+    fprintf( out, "\t\tif ( s[n]>='0' && s[n]<='9' ) c=(c<<4)|(uint32_t)(s[n]-'0');\n" );
+    fprintf( out, "\t\telse if ( s[n]>='A' && s[n]<='F' ) c=(c<<4)|(uint32_t)(s[n]-'A'+10);\n" );
+    fprintf( out, "\t\telse break;\n\t}\n" );
+    fprintf( out, "\tif ( n<4 || n>6 || c>0x10ffff || (s+n<end && s[n]!=' ') ) return( 0 );\n" );
+    fprintf( out, "\t*code=c;\n\treturn( n );\n}\n\n" );
+    fprintf( out, "/* Return the next line of annot at *pos, and move *pos to the next line. */\n" );
+    fprintf( out, "/* The line is not copied, text, name and tag point inside annot. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "int uniNamesList_annotNext%s(const char *annot, size_t *pos, struct unicode_annotline *line) {\n", lg[l] );
+    fprintf( out, "\tconst char *pt, *end, *e;\n\tsize_t n;\n\n" );
+    fprintf( out, "\tif ( pos==NULL || line==NULL ) return( -1 );\n" );
+    fprintf( out, "\tif ( annot==NULL || annot[*pos]=='\\0' ) return( 0 );\n" );
+    fprintf( out, "\tpt=annot+*pos;\n\tif ( (end=strchr(pt,'\\n'))==NULL ) {\n" );
+    fprintf( out, "\t\tend=pt+strlen(pt);\n\t\t*pos=(size_t)(end-annot);\n\t} else\n" );
+    fprintf( out, "\t\t*pos=(size_t)(end-annot)+1;\n\tline->name=line->tag=NULL;\n" );
+    fprintf( out, "\tline->namelen=line->taglen=0;\n\tline->count=0;\n" );
+    fprintf( out, "\tif ( *pt=='\\t' && pt+1<end && strchr(\"*%%x~:#=\",pt[1])!=NULL ) {\n" );
+    fprintf( out, "\t\tline->kind=pt[1];\n\t\tpt+=2;\n\t\tif ( pt<end && *pt==' ' ) ++pt;\n" );
+    fprintf( out, "\t} else {\n" );
+    fprintf( out, "\t\t/* A comment continued on a line starting with two tabs */\n" );
+    fprintf( out, "\t\tline->kind='\\t';\n\t\twhile ( pt<end && *pt=='\\t' ) ++pt;\n\t}\n" );
+    fprintf( out, "\tline->text=pt;\n\tline->len=(size_t)(end-pt);\n\n" );
+    fprintf( out, "\tif ( line->kind=='x' ) {\n" );
+    fprintf( out, "\t\t/* \"x (name - 0041)\" or \"x 0041\" */\n" );
+    fprintf( out, "\t\tif ( *pt=='(' && end-pt>8 && end[-1]==')' ) {\n" );
+    fprintf( out, "\t\t\tfor ( e=end-1; e>pt && e[-1]!=' '; --e );\n" );
+    fprintf( out, "\t\t\tif ( e-pt>3 && e[-2]=='-' && e[-3]==' ' && unicode_annothex(e,end-1,&line->seq[0])==(size_t)(end-1-e) ) {\n" );
+    fprintf( out, "\t\t\t\tline->name=pt+1;\n\t\t\t\tline->namelen=(size_t)(e-3-pt-1);\n" );
+    fprintf( out, "\t\t\t\tline->count=1;\n\t\t\t}\n" );
+    fprintf( out, "\t\t} else if ( unicode_annothex(pt,end,&line->seq[0])==line->len )\n" );
+    fprintf( out, "\t\t\tline->count=1;\n" );
+    fprintf( out, "\t} else if ( line->kind==':' || line->kind=='#' || line->kind=='~' ) {\n" );
+    fprintf( out, "\t\t/* \": 0041 0301\", \"# <tag> 0020 0301\" or \"~ 0030 FE00 description\" */\n" );
+    fprintf( out, "\t\tif ( line->kind=='#' && *pt=='<' && (e=(const char *)(memchr(pt,'>',(size_t)(end-pt))))!=NULL ) {\n" );
+    fprintf( out, "\t\t\tline->tag=pt+1;\n\t\t\tline->taglen=(size_t)(e-pt-1);\n" );
+    fprintf( out, "\t\t\tpt=e+1;\n\t\t\tif ( pt<end && *pt==' ' ) ++pt;\n\t\t}\n" );
+    fprintf( out, "\t\twhile ( line->count<UN_ANNOT_SEQ_MAX && (n=unicode_annothex(pt,end,&line->seq[line->count]))>0 ) {\n" );
+    fprintf( out, "\t\t\t++line->count;\n\t\t\tpt+=n;\n\t\t\tif ( pt<end ) ++pt;\n\t\t}\n" );
+    fprintf( out, "\t\tif ( line->count>0 && pt<end ) {\n\t\t\tline->name=pt;\n" );
+    fprintf( out, "\t\t\tline->namelen=(size_t)(end-pt);\n\t\t}\n\t}\n\treturn( 1 );\n}\n" );
+    return( 1 );
+}
+
+/* The x cross-references are the "x (name - XXXX)" and "x XXXX" lines. */
+/* Return the unicode value of the line pt..end, or -1 if not a code. */
+static long xreftarget(const char *pt, const char *end) {
+    const char *e;
+    long u;
+
+    if ( *pt=='(' ) {
+	if ( end-pt<10 || end[-1]!=')' ) return( -1 );
+	--end;
+	for ( e=end; e>pt && e[-1]!=' '; --e );
+	if ( e-pt<4 || e[-2]!='-' || e[-3]!=' ' ) return( -1 );
+	pt = e;
+    }
+    if ( end-pt<4 || end-pt>6 ) return( -1 );
+    for ( u=0; pt<end; ++pt ) {
+	if ( *pt>='0' && *pt<='9' ) u = (u<<4)+*pt-'0';
+	else if ( *pt>='A' && *pt<='F' ) u = (u<<4)+*pt-'A'+10;
+	else return( -1 );
+    }
+    return( u<0x110000 ? u : -1 );
+}
+
+struct xref { uint32_t from, to; };
+
+static int cmpxrefback(const void *a, const void *b) {
+    const struct xref *xa = (const struct xref *)(a), *xb = (const struct xref *)(b);
+
+    if ( xa->to!=xb->to ) return( xa->to<xb->to ? -1 : 1 );
+    if ( xa->from!=xb->from ) return( xa->from<xb->from ? -1 : 1 );
+    return( 0 );
+}
+
+static int dumpxref(FILE *out, int is_fr) {
+    struct xref *fwd=NULL, *back=NULL, *tmp;
+    uint32_t *node=NULL, *ofs=NULL, *mid=NULL, *list=NULL;
+    uint32_t ne, max, nn, np, i, j, f, b, u, k;
+    const char *pt, *end, *type;
+    long t;
+    int l, ok=0;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    /* Edges in order of the annotation lines, without repeats */
+    for ( u=ne=max=0; u<17*65536; ++u ) if ( (pt=uniannot[l][u])!=NULL ) {
+	for ( ; *pt!='\0'; pt=*end ? end+1 : end ) {
+	    if ( (end=strchr(pt,'\n'))==NULL ) end = pt+strlen(pt);
+	    if ( strncmp(pt,"\tx ",3)!=0 || (t=xreftarget(pt+3,end))<0 ) continue;
+	    for ( j=ne; j>0 && fwd[j-1].from==u && fwd[j-1].to!=(uint32_t)(t); --j );
+	    if ( j>0 && fwd[j-1].from==u ) continue;
+	    if ( ne>=max ) {
+		max += 4096;
+		if ( (tmp=(struct xref *)(realloc(fwd,max*sizeof(struct xref))))==NULL ) goto errorxref;
+		fwd = tmp;
+	    }
+	    fwd[ne].from = u; fwd[ne++].to = (uint32_t)(t);
+	}
+    }
+
+    fprintf( out, "/* Cross-references from the x annotation lines, see uniNamesList_xrefs%s() */\n", lg[l] );
+    if ( ne==0 ) {
+	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_xrefs%s(unsigned long uni, const uint32_t **out) {\n", lg[l] );
+	fprintf( out, "\tif ( out!=NULL ) *out=NULL;\n\treturn( out==NULL || uni>=0x110000 ? -1 : 0 );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_xrefsBack%s(unsigned long uni, const uint32_t **out) {\n", lg[l] );
+	fprintf( out, "\treturn( uniNamesList_xrefs%s(uni,out) );\n}\n\n", lg[l] );
+	ok = 1;
+	goto errorxref;
+    }
+
+    /* Nodes are all values with edges either way, sorted */
+    if ( (back=(struct xref *)(malloc(ne*sizeof(struct xref))))==NULL || \
+	 (node=(uint32_t *)(malloc(2*ne*sizeof(uint32_t))))==NULL || \
+	 (ofs=(uint32_t *)(malloc((2*ne+1)*sizeof(uint32_t))))==NULL || \
+	 (mid=(uint32_t *)(malloc(2*ne*sizeof(uint32_t))))==NULL || \
+	 (list=(uint32_t *)(malloc(2*ne*sizeof(uint32_t))))==NULL )
+	goto errorxref;
+    memcpy(back,fwd,ne*sizeof(struct xref));
+    qsort(back,ne,sizeof(struct xref),cmpxrefback);
+    for ( i=f=b=nn=k=0; f<ne || b<ne; ++nn ) {
+	if ( b>=ne || (f<ne && fwd[f].from<=back[b].to) )
+	    u = fwd[f].from;
+	else
+	    u = back[b].to;
+	node[nn] = u; ofs[nn] = k;
+	for ( ; f<ne && fwd[f].from==u; ++f ) list[k++] = fwd[f].to;
+	mid[nn] = k;
+	for ( ; b<ne && back[b].to==u; ++b ) list[k++] = back[b].from;
+    }
+    ofs[nn] = k;
+    np = (node[nn-1]>>8)+1;
+    type = k>65535 || nn>65535 ? "uint32_t" : "uint16_t";
+
+    fprintf( out, "/* unicode_xrefnode%s[k] refers to unicode_xref%s[] from unicode_xrefofs%s[k] */\n", lg[l], lg[l], lg[l] );
+    fprintf( out, "/* to unicode_xrefmid%s[k], and is referred to by the rest to ofs[k+1]. */\n", lg[l] );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_xref%s[%u] = {", lg[l], k );
+    dumpuint32s(out,list,k);
+    fprintf( out, "UN_DLL_LOCAL\nstatic const uint32_t unicode_xrefnode%s[%u] = {", lg[l], nn );
+    dumpuint32s(out,node,nn);
+    fprintf( out, "UN_DLL_LOCAL\nstatic const %s unicode_xrefofs%s[%u] = {", type, lg[l], nn+1 );
+    for ( i=0; i<=nn; ++i )
+	fprintf( out, "%s%u%s", (i&15) ? " " : "\n\t", ofs[i], i<nn ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const %s unicode_xrefmid%s[%u] = {", type, lg[l], nn );
+    for ( i=0; i<nn; ++i )
+	fprintf( out, "%s%u%s", (i&15) ? " " : "\n\t", mid[i], i+1<nn ? "," : "" );
+    fprintf( out, "\n};\n\n" );
+    fprintf( out, "/* First node of each 256 codepoint page, the page's nodes end at the next. */\n" );
+    fprintf( out, "UN_DLL_LOCAL\nstatic const %s unicode_xrefpage%s[%u] = {", type, lg[l], np+1 );
+    for ( i=j=0; i<=np; ++i ) {
+	for ( ; j<nn && (node[j]>>8)<i; ++j );
+	fprintf( out, "%s%u%s", (i&15) ? " " : "\n\t", j, i<np ? "," : "" );
+    }
+    fprintf( out, "\n};\n\n" );
+
+    fprintf( out, "static int unicode_xreffind%s(unsigned long uni) {\n", lg[l] );
+    fprintf( out, "\tunsigned int lo, hi, m;\n\n" );
+    fprintf( out, "\tif ( uni>=0x%X ) return( -1 );\n", np<<8 );
+    fprintf( out, "\tlo=unicode_xrefpage%s[uni>>8]; hi=unicode_xrefpage%s[(uni>>8)+1];\n", lg[l], lg[l] );
+    fprintf( out, "\twhile ( lo<hi ) {\n\t\tm=(lo+hi)/2;\n" );
+    fprintf( out, "\t\tif ( unicode_xrefnode%s[m]<uni ) lo=m+1;\n", lg[l] );
+    fprintf( out, "\t\telse if ( unicode_xrefnode%s[m]>uni ) hi=m;\n", lg[l] );
+    fprintf( out, "\t\telse return( (int)(m) );\n\t}\n\treturn( -1 );\n}\n\n" );
+    fprintf( out, "/* Return count of unicode values in the x cross-references of this unicode */\n" );
+    fprintf( out, "/* value, and point *out to them, or NULL if there are none (-1 if error). */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_xrefs%s(unsigned long uni, const uint32_t **out) {\n", lg[l] );
+    fprintf( out, "\tint k, n=0;\n\n\tif ( out==NULL ) return( -1 );\n\t*out=NULL;\n" );
+    fprintf( out, "\tif ( uni>=0x110000 ) return( -1 );\n" );
+    fprintf( out, "\tif ( (k=unicode_xreffind%s(uni))>=0 && (n=(int)(unicode_xrefmid%s[k]-unicode_xrefofs%s[k]))>0 )\n", lg[l], lg[l], lg[l] );
+    fprintf( out, "\t\t*out=unicode_xref%s+unicode_xrefofs%s[k];\n\treturn( n );\n}\n\n", lg[l], lg[l] );
+    fprintf( out, "/* Same for the unicode values that have this one in their x references. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_xrefsBack%s(unsigned long uni, const uint32_t **out) {\n", lg[l] );
+    fprintf( out, "\tint k, n=0;\n\n\tif ( out==NULL ) return( -1 );\n\t*out=NULL;\n" );
+    fprintf( out, "\tif ( uni>=0x110000 ) return( -1 );\n" );
+    fprintf( out, "\tif ( (k=unicode_xreffind%s(uni))>=0 && (n=(int)(unicode_xrefofs%s[k+1]-unicode_xrefmid%s[k]))>0 )\n", lg[l], lg[l], lg[l] );
+    fprintf( out, "\t\t*out=unicode_xref%s+unicode_xrefmid%s[k];\n\treturn( n );\n}\n\n", lg[l], lg[l] );
+    ok = 1;
+
+errorxref:
+    if ( ok && is_fr==0 ) {
+	fprintf( out, "/* Same as above using lang. Return English if language has no references. */\n" );
+	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_xrefsAlt(unsigned long uni, unsigned int lang, const uint32_t **out) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n\tint n;\n\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->xrefs!=NULL && (n=pack->xrefs(uni,out))!=0 )\n" );
+	fprintf( out, "\t\treturn( n );\n\treturn( uniNamesList_xrefs(uni,out) );\n}\n\n" );
+	fprintf( out, "UN_DLL_EXPORT\nint uniNamesList_xrefsBackAlt(unsigned long uni, unsigned int lang, const uint32_t **out) {\n" );
+	fprintf( out, "\tconst struct unicode_langpack *pack=unicode_langpack(lang);\n\tint n;\n\n" );
+	fprintf( out, "\tif ( pack!=NULL && pack->xrefsBack!=NULL && (n=pack->xrefsBack(uni,out))!=0 )\n" );
+	fprintf( out, "\t\treturn( n );\n\treturn( uniNamesList_xrefsBack(uni,out) );\n}\n" );
+    }
+    if ( !ok ) fprintf( stderr, "Cannot make cross-reference table\n" );
+    free(fwd); free(back); free(node); free(ofs); free(mid); free(list);
+    return( ok );
+}
+
+/* buildnameslist also writes the names, annotations and blocks into a data */
+/* file that uniNamesList_open() maps into memory, so a new NamesList can be */
+/* used without building the library again. The file has a header of 32bit */
+/* little-endian values, then these sections (aligned on 8 bytes, all 32bit */
+/* little-endian values but the strings), with offsets from the start of */
+/* the file. The same header is struct unicode_filehead in nameslist.c, */
+/* where the sections are described. */
+#define FILE_VERSION 1
+
+struct filehead {
+    char magic[8];
+    uint32_t version, byteorder, size, lang, nlversion, pool, poolsize;
+    uint32_t blockcnt, blocks, pagemap, pagecnt, pages;
+    uint32_t namecnt, byname, rangecnt, ranges, jamo;
+};
+
+static const char *jamoname[19+21+28] = {
+    "G", "GG", "N", "D", "DD", "R", "M", "B", "BB", "S", "SS", "", "J", "JJ",
+    "C", "K", "T", "P", "H",
+    "A", "AE", "YA", "YAE", "EO", "E", "YEO", "YE", "O", "WA", "WAE", "OE",
+    "YO", "U", "WEO", "WE", "WI", "YU", "EU", "YI", "I",
+    "", "G", "GG", "GS", "N", "NJ", "NH", "D", "L", "LG", "LM", "LB", "LS", "LT",
+    "LP", "LH", "M", "B", "BS", "S", "SS", "NG", "J", "C", "K", "T", "P", "H"
+};
+static const char *rangefixed[3] = { "HANGUL SYLLABLE ", "CJK UNIFIED IDEOGRAPH-", "TANGUT IDEOGRAPH-" };
+
+static PERTHREAD char *filepool;
+static PERTHREAD uint32_t filepoolsize;
+static PERTHREAD struct poolstr *filestrs;
+static PERTHREAD uint32_t filestrcnt, filestrmax;
+static PERTHREAD int filepoolerr;
+
+/* Ask for len characters of str and a '\0' to be in the pool. Its offset */
+/* is put in *ofs once filepoolmake() has laid out the pool. */
+static void filestring(uint32_t *ofs, const char *str, size_t len) {
+    struct poolstr *pt;
+
+    *ofs = 0;
+    if ( filestrcnt>=filestrmax ) {
+	filestrmax = filestrmax*2+1024;
+	if ( (pt=(struct poolstr *)(realloc(filestrs,filestrmax*sizeof(struct poolstr))))==NULL ) {
+	    filepoolerr = 1;
+	    return;
+	}
+	filestrs = pt;
+    }
+    filestrs[filestrcnt].str = str;
+    filestrs[filestrcnt].ofs = ofs;
+    filestrs[filestrcnt++].len = (uint32_t)(len);
+}
+
+/* Make the pool, starting with an empty string at offset 0 which is NULL */
+static uint32_t filepoolmake(void) {
+    uint32_t i, saved;
+
+    if ( filepoolerr )
+	return( 0 );
+    saved = pooltails(filestrs,filestrcnt);
+    for ( i=0, filepoolsize=1; i<filestrcnt; ++i ) if ( filestrs[i].tail==i )
+	filepoolsize += filestrs[i].len+1;
+    if ( (filepool=(char *)(malloc(filepoolsize)))==NULL )
+	return( 0 );
+    for ( i=0, filepoolsize=1, filepool[0]='\0'; i<filestrcnt; ++i ) if ( filestrs[i].tail==i ) {
+	*filestrs[i].ofs = filepoolsize;
+	memcpy(filepool+filepoolsize,filestrs[i].str,filestrs[i].len);
+	filepool[filepoolsize+filestrs[i].len] = '\0';
+	filepoolsize += filestrs[i].len+1;
+    }
+    poolshared(filestrs,filestrcnt);
+    return( saved );
+}
+
+static int cmpfilename(const void *a, const void *b) {
+    return( strcmp(uninames[0][*(const uint32_t *)(a)],uninames[0][*(const uint32_t *)(b)]) );
+}
+
+static int cmpfilenameFR(const void *a, const void *b) {
+    return( strcmp(uninames[1][*(const uint32_t *)(a)],uninames[1][*(const uint32_t *)(b)]) );
+}
+
+static int writesection(FILE *out, const void *data, uint32_t size) {
+    static const char zero[8] = { 0 };
+
+    if ( size>0 && fwrite(data,1,size,out)!=size ) return( 0 );
+    if ( (size&7) && fwrite(zero,1,8-(size&7),out)!=8-(size&7) ) return( 0 );
+    return( 1 );
+}
+
+/* Data files are little-endian, so swap the words of data in place if */
+/* this machine is not, before they are written. */
+static void filelittle(void *data, uint32_t size) {
+    static const uint32_t one = 1;
+    unsigned char *pt = (unsigned char *)(data), t;
+
+    if ( *(const unsigned char *)(&one)==1 )
+	return;
+    for ( ; size>=4; size-=4, pt+=4 ) {
+	t = pt[0]; pt[0] = pt[3]; pt[3] = t;
+	t = pt[1]; pt[1] = pt[2]; pt[2] = t;
+    }
+}
+
+static uint32_t filealign(uint32_t size) {
+    return( (size+7)&~7u );
+}
+
+static int dumpfile(int is_fr) {
+    struct filehead h, lh;
+    struct block *block;
+    uint32_t *blocks=NULL, *pagemap=NULL, *pages=NULL, *byname=NULL, rangetab[4*32], jamo[19+21+28];
+    uint32_t i, j, k, u, saved, null2=0xffffffff;
+    char version[80];
+    FILE *out=NULL;
+    int l, kind, ok=0;
+
+    l = is_fr; if ( is_fr<0 ) l = 0;
+
+    memset(&h,0,sizeof(h));
+    memcpy(h.magic,"UNINAMES",8);
+    h.version = FILE_VERSION;
+    h.byteorder = 0x01020304;
+    filepool = NULL; filestrcnt = 0; filepoolerr = 0;
+    filestring(&h.lang,is_fr ? "FR" : "EN",2);
+    sprintf( version, "Nameslist-Version: %s", lgv[l] );
+    filestring(&h.nlversion,version,strlen(version));
+
+    for ( block = head[l]; block!=NULL; block=block->next ) ++h.blockcnt;
+    if ( (blocks=(uint32_t *)(malloc((3*h.blockcnt+1)*sizeof(uint32_t))))==NULL || \
+	 (pagemap=(uint32_t *)(malloc(0x1100*sizeof(uint32_t))))==NULL || \
+	 (pages=(uint32_t *)(malloc(0x1100*512*sizeof(uint32_t))))==NULL || \
+	 (byname=(uint32_t *)(malloc(17*65536*sizeof(uint32_t))))==NULL )
+	goto errorfile;
+    for ( block = head[l], i=0; block!=NULL; block=block->next, ++i ) {
+	/* uniNamesList_blockNumberFile() does a binary search */
+	if ( block->start>block->end || (i>0 && (uint32_t)(block->start)<=blocks[3*i-2]) )
+	    goto errorfile;
+	blocks[3*i] = (uint32_t)(block->start);
+	blocks[3*i+1] = (uint32_t)(block->end);
+	filestring(&blocks[3*i+2],block->name,strlen(block->name));
+    }
+
+    /* Pages are the same as in the library, see pagekind() */
+    for ( i=0; i<17; ++i ) for ( j=0; j<256; ++j ) {
+	kind = emptyplane(l,i) ? (j==255 ? 2 : 0) : pagekind(l,i,j);
+	pagemap[(i<<8)+j] = 0xffffffff;
+	if ( kind==2 ) {
+	    if ( null2==0xffffffff ) {
+		null2 = h.pagecnt++;
+		memset(pages+null2*512,0,512*sizeof(uint32_t));
+		for ( k=0; k<2; ++k )
+		    filestring(&pages[null2*512+(0xfe + k)*2+1],nullannot[l][k],strlen(nullannot[l][k]));
+	    }
+	    pagemap[(i<<8)+j] = null2;
+	} else if ( kind==1 ) {
+	    for ( k=0; k<256; ++k ) {
+		u = (i<<16)+(j<<8)+k;
+		pages[h.pagecnt*512+k*2] = pages[h.pagecnt*512+k*2+1] = 0;
+		if ( uninames[l][u]!=NULL )
+		    filestring(&pages[h.pagecnt*512+k*2],uninames[l][u],strlen(uninames[l][u]));
+		if ( uniannot[l][u]!=NULL )
+		    filestring(&pages[h.pagecnt*512+k*2+1],uniannot[l][u],dumplength(uniannot[l][u]));
+		if ( uninames[l][u]!=NULL ) byname[h.namecnt++] = u;
+	    }
+	    pagemap[(i<<8)+j] = h.pagecnt++;
+	}
+    }
+    qsort(byname,h.namecnt,sizeof(uint32_t),l ? cmpfilenameFR : cmpfilename);
+
+    for ( k=0; k<(uint32_t)(rangecnt[l]); ++k ) {
+	rangetab[4*k] = (uint32_t)(ranges[l][k].start);
+	rangetab[4*k+1] = (uint32_t)(ranges[l][k].end);
+	rangetab[4*k+2] = (uint32_t)(ranges[l][k].kind);
+	filestring(&rangetab[4*k+3],rangefixed[ranges[l][k].kind],strlen(rangefixed[ranges[l][k].kind]));
+    }
+    h.rangecnt = (uint32_t)(rangecnt[l]);
+    if ( h.rangecnt>0 )
+	for ( k=0; k<19+21+28; ++k )
+	    filestring(&jamo[k],jamoname[k],strlen(jamoname[k]));
+    saved = filepoolmake();
+    if ( filepool==NULL || filepoolerr )
+	goto errorfile;
+
+    h.blocks = filealign(sizeof(h));
+    h.pagemap = h.blocks+filealign(3*h.blockcnt*4);
+    h.pages = h.pagemap+filealign(0x1100*4);
+    h.byname = h.pages+filealign(h.pagecnt*512*4);
+    h.ranges = h.byname+filealign(h.namecnt*4);
+    h.jamo = h.ranges+filealign(h.rangecnt*4*4);
+    h.pool = h.jamo+(h.rangecnt>0 ? filealign((19+21+28)*4) : 0);
+    h.poolsize = filepoolsize;
+    h.size = h.pool+filealign(h.poolsize);
+    if ( h.rangecnt==0 ) h.jamo = 0;
+
+    lh = h; filelittle((char *)(&lh)+8,sizeof(lh)-8);
+    filelittle(blocks,3*h.blockcnt*4); filelittle(pagemap,0x1100*4);
+    filelittle(pages,h.pagecnt*512*4); filelittle(byname,h.namecnt*4);
+    filelittle(rangetab,h.rangecnt*4*4); filelittle(jamo,(19+21+28)*4);
+    if ( (out=fopen(is_fr ? "nameslist-fr.dat" : "nameslist.dat","wb"))==NULL || \
+	 !writesection(out,&lh,sizeof(lh)) || !writesection(out,blocks,3*h.blockcnt*4) || \
+	 !writesection(out,pagemap,0x1100*4) || !writesection(out,pages,h.pagecnt*512*4) || \
+	 !writesection(out,byname,h.namecnt*4) || !writesection(out,rangetab,h.rangecnt*4*4) || \
+	 (h.rangecnt>0 && !writesection(out,jamo,(19+21+28)*4)) || \
+	 !writesection(out,filepool,h.poolsize) )
+	goto errorfile;
+    fprintf( stdout, "%s data file: %u bytes, %u saved by sharing the same text\n", is_fr ? "French" : "English", h.size, saved );
+    ok = 1;
+
+errorfile:
+    if ( out!=NULL && fclose(out)!=0 ) ok = 0;
+    if ( !ok ) fprintf( stderr, "Cannot write data file\n" );
+    free(blocks); free(pagemap); free(pages); free(byname); free(filepool); free(filestrs);
+    filepool = NULL; filestrs = NULL; filestrmax = 0;
+    return( ok );
+}
+
+
+static int dumpopen(FILE *out, int is_fr) {
+    /* The data file functions are in the English library only, the file */
+    /* itself tells the language. */
+    if ( is_fr!=0 )
+	return( 1 );
+
+    fprintf( out, "\n" );
+    fprintf( out, "/* The data file made by buildnameslist starts with this header. Values are */\n" );
+    fprintf( out, "/* little-endian uint32_t, and offsets are from the start of the file, so */\n" );
+    fprintf( out, "/* it can be mapped anywhere and shared. */\n" );
+    fprintf( out, "struct unicode_filehead {\n\tchar magic[8];\t\t\t/* \"UNINAMES\" */\n" );
+    fprintf( out, "\tuint32_t version, byteorder;\t/* UN_FILE_VERSION, 0x01020304 */\n" );
+    fprintf( out, "\tuint32_t size, lang, nlversion;\t/* file size, then pool offsets */\n" );
+    fprintf( out, "\tuint32_t pool, poolsize;\t/* strings, all '\\0' ended */\n" );
+    fprintf( out, "\tuint32_t blockcnt, blocks;\t/* {start,end,name} sorted by start */\n" );
+    fprintf( out, "\tuint32_t pagemap, pagecnt, pages; /* 0x1100 page numbers, 256*{name,annot} */\n" );
+    fprintf( out, "\tuint32_t namecnt, byname;\t/* unicode values sorted by name */\n" );
+    fprintf( out, "\tuint32_t rangecnt, ranges;\t/* {start,end,kind,prefix} made names */\n" );
+    fprintf( out, "\tuint32_t jamo;\t\t\t/* 19+21+28 jamo name offsets, or 0 */\n};\n\n" );
+    fprintf( out, "#define UN_FILE_VERSION\t1\n\n" );
+    fprintf( out, "struct unicode_names {\n\tconst char *base, *pool;\n\tsize_t size;\n" );
+    fprintf( out, "\tconst uint32_t *blocks, *pagemap, *pages, *byname, *ranges, *jamo;\n" );
+    fprintf( out, "\tstruct unicode_filehead h;\n\tint mapped;\n};\n\n" );
+    fprintf( out, "static UN_THREAD char unicode_filebuf[64];\n\n" );
+    fprintf( out, "/* Return pointer to n uint32_t at offset o of file, NULL if not inside. */\n" );
+    fprintf( out, "static const uint32_t *unicode_filearray(const struct unicode_names *file, uint32_t o, uint32_t n) {\n" );
+    fprintf( out, "\tif ( o==0 || (o&3) || o>file->size || n>(file->size-o)/4 ) return( NULL );\n" );
+    fprintf( out, "\treturn( (const uint32_t *)(const void *)(file->base+o) );\n}\n\n" );
+    fprintf( out, "static const char *unicode_filestring(const struct unicode_names *file, uint32_t o) {\n" );
+    fprintf( out, "\treturn( o>0 && o<file->h.poolsize ? file->pool+o : NULL );\n}\n\n" );
+    fprintf( out, "/* The file is in the other byte order. Everything before the string pool */\n" );
+    fprintf( out, "/* is uint32_t, so swap that in a copy of the file in memory. */\n" );
+    fprintf( out, "static int unicode_fileswap(struct unicode_names *file) {\n" );
+    fprintf( out, "\tunsigned char *buf, t;\n\tuint32_t pool;\n\tsize_t i;\n\n" );
+    fprintf( out, "\tmemcpy(&pool,file->base+offsetof(struct unicode_filehead,pool),sizeof(pool));\n" );
+    fprintf( out, "\tpool=(pool>>24)|((pool>>8)&0xff00)|((pool&0xff00)<<8)|(pool<<24);\n" );
+    fprintf( out, "\tif ( pool>file->size || (pool&3) ) return( -1 );\n#ifdef HAVE_MMAP\n" );
+    fprintf( out, "\tif ( file->mapped ) {\n" );
+    fprintf( out, "\t\tif ( (buf=(unsigned char *)(malloc(file->size)))==NULL ) return( -1 );\n" );
+    fprintf( out, "\t\tmemcpy(buf,file->base,file->size);\n" );
+    fprintf( out, "\t\tmunmap((void *)(uintptr_t)(file->base),file->size);\n" );
+    fprintf( out, "\t\tfile->base=(const char *)(buf);\n\t\tfile->mapped=0;\n\t}\n#endif\n" );
+    fprintf( out, "\tbuf=(unsigned char *)(uintptr_t)(file->base);\n" );
+    fprintf( out, "\tfor ( i=8; i<pool; i+=4 ) {\n" );
+    fprintf( out, "\t\tt=buf[i]; buf[i]=buf[i+3]; buf[i+3]=t;\n" );
+    fprintf( out, "\t\tt=buf[i+1]; buf[i+1]=buf[i+2]; buf[i+2]=t;\n\t}\n" );
+    fprintf( out, "\tmemcpy(&file->h,file->base,sizeof(struct unicode_filehead));\n" );
+    fprintf( out, "\treturn( 0 );\n}\n\n" );
+    fprintf( out, "/* Open a data file made by buildnameslist, mapped into memory if possible. */\n" );
+    fprintf( out, "/* Return a handle for the ...File() functions, or NULL if not valid. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "struct unicode_names *uniNamesList_open(const char *path) {\n" );
+    fprintf( out, "\tstruct unicode_names *file;\n\tFILE *fp;\n\tlong size;\n" );
+    fprintf( out, "\tuint32_t i;\n#ifdef HAVE_MMAP\n\tvoid *pt;\n#endif\n\n" );
+    fprintf( out, "\tif ( path==NULL || (fp=fopen(path,\"rb\"))==NULL ) return( NULL );\n" );
+    fprintf( out, "\tif ( fseek(fp,0,SEEK_END)!=0 || (size=ftell(fp))<(long)(sizeof(struct unicode_filehead)) || \\\n" );
+    fprintf( out, "\t     (unsigned long)(size)>0xffffffffUL || (file=(struct unicode_names *)(calloc(1,sizeof(struct unicode_names))))==NULL ) {\n" );
+    fprintf( out, "\t\tfclose(fp);\n\t\treturn( NULL );\n\t}\n" );
+    fprintf( out, "\tfile->size=(size_t)(size);\n#ifdef HAVE_MMAP\n" );
+    fprintf( out, "\tif ( (pt=mmap(NULL,file->size,PROT_READ,MAP_SHARED,fileno(fp),0))!=MAP_FAILED ) {\n" );
+    fprintf( out, "\t\tfile->base=(const char *)(pt);\n\t\tfile->mapped=1;\n\t}\n#endif\n" );
+    fprintf( out, "\tif ( file->base==NULL ) {\n" );
+    fprintf( out, "\t\t/* No mmap(), so read the file into memory instead */\n" );
+    fprintf( out, "\t\tchar *buf=(char *)(malloc(file->size));\n\n" );
+    fprintf( out, "\t\tif ( buf==NULL || fseek(fp,0,SEEK_SET)!=0 || fread(buf,1,file->size,fp)!=file->size ) {\n" );
+    fprintf( out, "\t\t\tfree(buf); free(file); fclose(fp);\n\t\t\treturn( NULL );\n\t\t}\n" );
+    fprintf( out, "\t\tfile->base=buf;\n\t}\n\tfclose(fp);\n\n" );
+    fprintf( out, "\tmemcpy(&file->h,file->base,sizeof(struct unicode_filehead));\n" );
+    fprintf( out, "\tif ( (file->h.byteorder==0x04030201 && unicode_fileswap(file)!=0) || \\\n" );
+    fprintf( out, "\t     memcmp(file->h.magic,\"UNINAMES\",8)!=0 || file->h.version!=UN_FILE_VERSION || \\\n" );
+    fprintf( out, "\t     file->h.byteorder!=0x01020304 || file->h.size!=file->size || \\\n" );
+    fprintf( out, "\t     file->h.pool>file->size || file->h.poolsize==0 || file->h.poolsize>file->size-file->h.pool || \\\n" );
+    fprintf( out, "\t     file->base[file->h.pool+file->h.poolsize-1]!='\\0' || \\\n" );
+    fprintf( out, "\t     (file->blocks=unicode_filearray(file,file->h.blocks,3*file->h.blockcnt))==NULL || \\\n" );
+    fprintf( out, "\t     (file->pagemap=unicode_filearray(file,file->h.pagemap,0x1100))==NULL || \\\n" );
+    fprintf( out, "\t     (file->pages=unicode_filearray(file,file->h.pages,512*file->h.pagecnt))==NULL || \\\n" );
+    fprintf( out, "\t     (file->h.namecnt>0 && (file->byname=unicode_filearray(file,file->h.byname,file->h.namecnt))==NULL) || \\\n" );
+    fprintf( out, "\t     (file->h.rangecnt>0 && (file->ranges=unicode_filearray(file,file->h.ranges,4*file->h.rangecnt))==NULL) || \\\n" );
+    fprintf( out, "\t     (file->h.jamo>0 && (file->jamo=unicode_filearray(file,file->h.jamo,19+21+28))==NULL) ) {\n" );
+    fprintf( out, "\t\tuniNamesList_close(file);\n\t\treturn( NULL );\n\t}\n" );
+    fprintf( out, "\tfile->pool=file->base+file->h.pool;\n" );
+    fprintf( out, "\tfor ( i=0; i<file->h.rangecnt; ++i )\n" );
+    fprintf( out, "\t\tif ( file->ranges[4*i+2]>2 || (file->ranges[4*i+2]==0 && file->jamo==NULL) || \\\n" );
+    fprintf( out, "\t\t     unicode_filestring(file,file->ranges[4*i+3])==NULL || strlen(file->pool+file->ranges[4*i+3])>40 ) {\n" );
+    fprintf( out, "\t\t\tuniNamesList_close(file);\n\t\t\treturn( NULL );\n\t\t}\n" );
+    fprintf( out, "\treturn( file );\n}\n\n" );
+    fprintf( out, "/* Unmap the data file and free the handle. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\nvoid uniNamesList_close(struct unicode_names *file) {\n" );
+    fprintf( out, "\tif ( file==NULL ) return;\n#ifdef HAVE_MMAP\n\tif ( file->mapped ) {\n" );
+    fprintf( out, "\t\tmunmap((void *)(uintptr_t)(file->base),file->size);\n" );
+    fprintf( out, "\t\tfile->base=NULL;\n\t}\n#endif\n" );
+    fprintf( out, "\tfree((void *)(uintptr_t)(file->base));\n\tfree(file);\n}\n\n" );
+    fprintf( out, "/* Return the language (\"EN\", \"FR\") and NamesList version of this file. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "const char *uniNamesList_LanguageFile(const struct unicode_names *file) {\n" );
+    fprintf( out, "\treturn( file==NULL ? NULL : unicode_filestring(file,file->h.lang) );\n" );
+    fprintf( out, "}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "const char *uniNamesList_NamesListVersionFile(const struct unicode_names *file) {\n" );
+    fprintf( out, "\treturn( file==NULL ? NULL : unicode_filestring(file,file->h.nlversion) );\n" );
+    fprintf( out, "}\n\n" );
+    fprintf( out, "/* Offsets of name and annotation for uni, or NULL if there are none. */\n" );
+    fprintf( out, "static const uint32_t *unicode_fileentry(const struct unicode_names *file, unsigned long uni) {\n" );
+    fprintf( out, "\tuint32_t p;\n\n" );
+    fprintf( out, "\tif ( file==NULL || uni>=0x110000 || (p=file->pagemap[uni>>8])>=file->h.pagecnt ) return( NULL );\n" );
+    fprintf( out, "\treturn( file->pages+(p*256+(uni&0xff))*2 );\n}\n\n" );
+    fprintf( out, "/* Names made from the unicode value are put in a buffer for this thread. */\n" );
+    fprintf( out, "static const char *unicode_filerangename(const struct unicode_names *file, unsigned long uni) {\n" );
+    fprintf( out, "\tconst uint32_t *r;\n\tuint32_t i, s;\n\n" );
+    fprintf( out, "\tfor ( i=0; i<file->h.rangecnt; ++i ) {\n\t\tr=file->ranges+4*i;\n" );
+    fprintf( out, "\t\tif ( uni<r[0] || uni>r[1] ) continue;\n" );
+    fprintf( out, "\t\tstrcpy(unicode_filebuf,file->pool+r[3]);\n\t\tif ( r[2]==0 ) {\n" );
+    fprintf( out, "\t\t\ts=(uint32_t)(uni-r[0]);\n" );
+    fprintf( out, "\t\t\tif ( s>=19*21*28 ) return( NULL );\n" );
+    fprintf( out, "\t\t\tif ( unicode_filestring(file,file->jamo[s/588])==NULL || unicode_filestring(file,file->jamo[19+s%%588/28])==NULL || \\\n" );
+    fprintf( out, "\t\t\t     unicode_filestring(file,file->jamo[40+s%%28])==NULL || \\\n" );
+    fprintf( out, "\t\t\t     strlen(unicode_filebuf)+strlen(file->pool+file->jamo[s/588])+strlen(file->pool+file->jamo[19+s%%588/28])+ \\\n" );
+    fprintf( out, "\t\t\t     strlen(file->pool+file->jamo[40+s%%28])>=sizeof(unicode_filebuf) )\n" );
+    fprintf( out, "\t\t\t\treturn( NULL );\n" );
+    fprintf( out, "\t\t\tstrcat(unicode_filebuf,file->pool+file->jamo[s/588]);\n" );
+    fprintf( out, "\t\t\tstrcat(unicode_filebuf,file->pool+file->jamo[19+s%%588/28]);\n" );
+    fprintf( out, "\t\t\tstrcat(unicode_filebuf,file->pool+file->jamo[40+s%%28]);\n" );
+    fprintf( out, "\t\t} else\n" );
+    fprintf( out, "\t\t\tsprintf(unicode_filebuf+strlen(unicode_filebuf),\"%%04lX\",uni);\n" );
+    fprintf( out, "\t\treturn( unicode_filebuf );\n\t}\n\treturn( NULL );\n}\n\n" );
+    fprintf( out, "/* Same as uniNamesList_name() and uniNamesList_annot(), using file. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "const char *uniNamesList_nameFile(unsigned long uni, const struct unicode_names *file) {\n" );
+    fprintf( out, "\tconst uint32_t *e;\n\tconst char *pt=NULL;\n\n" );
+    fprintf( out, "\tif ( (e=unicode_fileentry(file,uni))!=NULL )\n" );
+    fprintf( out, "\t\tpt=unicode_filestring(file,e[0]);\n" );
+    fprintf( out, "\tif ( pt==NULL && file!=NULL && uni<0x110000 )\n" );
+    fprintf( out, "\t\tpt=unicode_filerangename(file,uni);\n\treturn( pt );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "const char *uniNamesList_annotFile(unsigned long uni, const struct unicode_names *file) {\n" );
+    fprintf( out, "\tconst uint32_t *e;\n\n" );
+    fprintf( out, "\tif ( (e=unicode_fileentry(file,uni))==NULL ) return( NULL );\n" );
+    fprintf( out, "\treturn( unicode_filestring(file,e[1]) );\n}\n\n" );
+    fprintf( out, "/* Same as the uniNamesList_block...() functions, using file. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "int uniNamesList_blockCountFile(const struct unicode_names *file) {\n" );
+    fprintf( out, "\treturn( file==NULL ? -1 : (int)(file->h.blockcnt) );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "int uniNamesList_blockNumberFile(unsigned long uni, const struct unicode_names *file) {\n" );
+    fprintf( out, "\tuint32_t lo, hi, m;\n\n" );
+    fprintf( out, "\tif ( file==NULL || uni>=0x110000 ) return( -1 );\n" );
+    fprintf( out, "\tfor ( lo=0, hi=file->h.blockcnt; lo<hi; ) {\n\t\tm=(lo+hi)/2;\n" );
+    fprintf( out, "\t\tif ( uni<file->blocks[3*m] ) hi=m;\n" );
+    fprintf( out, "\t\telse if ( uni>file->blocks[3*m+1] ) lo=m+1;\n" );
+    fprintf( out, "\t\telse return( (int)(m) );\n\t}\n\treturn( -1 );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "long uniNamesList_blockStartFile(int uniBlock, const struct unicode_names *file) {\n" );
+    fprintf( out, "\tif ( file==NULL || uniBlock<0 || (uint32_t)(uniBlock)>=file->h.blockcnt ) return( -1 );\n" );
+    fprintf( out, "\treturn( (long)(file->blocks[3*uniBlock]) );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "long uniNamesList_blockEndFile(int uniBlock, const struct unicode_names *file) {\n" );
+    fprintf( out, "\tif ( file==NULL || uniBlock<0 || (uint32_t)(uniBlock)>=file->h.blockcnt ) return( -1 );\n" );
+    fprintf( out, "\treturn( (long)(file->blocks[3*uniBlock+1]) );\n}\n\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "const char *uniNamesList_blockNameFile(int uniBlock, const struct unicode_names *file) {\n" );
+    fprintf( out, "\tif ( file==NULL || uniBlock<0 || (uint32_t)(uniBlock)>=file->h.blockcnt ) return( NULL );\n" );
+    fprintf( out, "\treturn( unicode_filestring(file,file->blocks[3*uniBlock+2]) );\n}\n\n" );
+    fprintf( out, "/* Return the Hangul syllable in range r named name (after the prefix). */\n" );
+    fprintf( out, "static long unicode_filehangul(const struct unicode_names *file, const char *name, const uint32_t *r) {\n" );
+    fprintf( out, "\tconst char *a, *b, *c;\n\tuint32_t l, v, t, u;\n\tsize_t i, j;\n\n" );
+    fprintf( out, "\tfor ( l=0; l<19; ++l ) {\n" );
+    fprintf( out, "\t\tif ( (a=unicode_filestring(file,file->jamo[l]))==NULL || strncmp(name,a,(i=strlen(a)))!=0 ) continue;\n" );
+    fprintf( out, "\t\tfor ( v=0; v<21; ++v ) {\n" );
+    fprintf( out, "\t\t\tif ( (b=unicode_filestring(file,file->jamo[19+v]))==NULL || strncmp(name+i,b,(j=strlen(b)))!=0 ) continue;\n" );
+    fprintf( out, "\t\t\tfor ( t=0; t<28; ++t ) {\n\t\t\t\tu=r[0]+(l*21+v)*28+t;\n" );
+    fprintf( out, "\t\t\t\tif ( (c=unicode_filestring(file,file->jamo[40+t]))!=NULL && strcmp(name+i+j,c)==0 && u<=r[1] )\n" );
+    fprintf( out, "\t\t\t\t\treturn( (long)(u) );\n\t\t\t}\n\t\t}\n\t}\n\treturn( -1 );\n" );
+    fprintf( out, "}\n\n" );
+    fprintf( out, "/* Same as uniNamesList_codepoint(), using file. */\n" );
+    fprintf( out, "UN_DLL_EXPORT\n" );
+    fprintf( out, "long uniNamesList_codepointFile(const char *name, const struct unicode_names *file) {\n" );
+    fprintf( out, "\tconst char *pt;\n\tuint32_t lo, hi, m, i, u;\n\tsize_t n;\n\tlong r;\n" );
+    fprintf( out, "\tint c;\n\n" );
+    fprintf( out, "\tif ( name==NULL || file==NULL ) return( -1 );\n" );
+    fprintf( out, "\tfor ( lo=0, hi=file->h.namecnt; lo<hi; ) {\n\t\tm=(lo+hi)/2;\n" );
+    fprintf( out, "\t\tif ( (pt=uniNamesList_nameFile(file->byname[m],file))==NULL ) return( -1 );\n" );
+    fprintf( out, "\t\tif ( (c=strcmp(name,pt))==0 ) return( (long)(file->byname[m]) );\n" );
+    fprintf( out, "\t\tif ( c<0 ) hi=m; else lo=m+1;\n\t}\n" );
+    fprintf( out, "\t/* Names made from the unicode value */\n" );
+    fprintf( out, "\tfor ( i=0; i<file->h.rangecnt; ++i ) {\n" );
+    fprintf( out, "\t\tpt=file->pool+file->ranges[4*i+3];\n\t\tn=strlen(pt);\n" );
+    fprintf( out, "\t\tif ( strncmp(name,pt,n)!=0 ) continue;\n" );
+    fprintf( out, "\t\tif ( file->ranges[4*i+2]==0 ) {\n" );
+    fprintf( out, "\t\t\tif ( (r=unicode_filehangul(file,name+n,file->ranges+4*i))>=0 )\n" );
+    fprintf( out, "\t\t\t\treturn( r );\n\t\t} else {\n" );
+    fprintf( out, "\t\t\tfor ( u=0, pt=name+n; *pt!='\\0' && pt<name+n+6; ++pt ) {\n" );
+    fprintf( out, "\t\t\t\tif ( *pt>='0' && *pt<='9' ) u=(u<<4)+(uint32_t)(*pt-'0');\n" );
+    fprintf( out, "\t\t\t\telse if ( *pt>='A' && *pt<='F' ) u=(u<<4)+(uint32_t)(*pt-'A'+10);\n" );
+    fprintf( out, "\t\t\t\telse break;\n\t\t\t}\n" );
+    fprintf( out, "\t\t\tif ( *pt=='\\0' && pt-name-(long)(n)>=4 && u>=file->ranges[4*i] && u<=file->ranges[4*i+1] && \\\n" );
+    fprintf( out, "\t\t\t     (pt=unicode_filerangename(file,u))!=NULL && strcmp(name,pt)==0 )\n" );
+    fprintf( out, "\t\t\t\treturn( (long)(u) );\n\t\t}\n\t}\n\treturn( -1 );\n}\n" );
+    return( 1 );
+}
+
+static int dump(int is_fr) {
+    int dumpOK=0;
+
+    FILE *out = fopen(is_fr ? "nameslist-fr.c":"nameslist.c","w");
+    if ( out==NULL ) {
+	fprintf( stderr, "Cannot open output file\n" );
+	return( dumpOK );
+    }
+    FILE *header = fopen( is_fr ? "uninameslist-fr.h": "uninameslist.h","w");
+    if ( header==NULL ) {
+	fprintf( stderr, "Cannot open output header file\n" );
+	fclose(out);
+	return( dumpOK );
+    }
+    setvbuf(out,NULL,_IOFBF,OBUFFSIZE);
+    setvbuf(header,NULL,_IOFBF,OBUFFSIZE);
+#ifdef HAVE_PTHREAD
+    /* Only this thread writes these, so lock once, not once per call */
+    flockfile(out); flockfile(header);
+#endif
+
+    if ( dumpinit(out,header,is_fr) && dumpblock(out,header,is_fr) && \
+	 dumparrays(out,header,is_fr) && dumpbatch(out,is_fr) && dumpnamed(out,is_fr) && \
+	 dumptext(out,is_fr) && dumpsearch(out,is_fr) && \
+	 dumpnamehash(out,is_fr) && dumploosehash(out,is_fr) && \
+	 dumpannot(out,is_fr) && dumpxref(out,is_fr) && \
+	 dumpopen(out,is_fr) && dumpend(header,is_fr) && dumpfile(is_fr) && \
+	 fflush(out)==0 && fflush(header)==0 )
+	dumpOK=1;
+#ifdef HAVE_PTHREAD
+    funlockfile(out); funlockfile(header);
+#endif
+    fclose(out); fclose(header);
+    return( dumpOK );
+}
+
+/* Elapsed seconds, since CPU time from clock() adds up both threads */
+static double now(void) {
+    time_t t;
+#ifdef HAVE_CLOCK_GETTIME
+    struct timespec ts;
+
+    if ( clock_gettime(CLOCK_MONOTONIC,&ts)==0 )
+	return( (double)(ts.tv_sec)+(double)(ts.tv_nsec)*1e-9 );
+#endif
+    t = time(NULL);
+    return( (double)(t) );
+}
+
+/* Show how long building took, and how much memory was needed */
+static void report(double start) {
+    clock_t ticks = clock();
+    long maxrss = -1;
+#ifdef HAVE_GETRUSAGE
+    struct rusage usage;
+
+    if ( getrusage(RUSAGE_SELF,&usage)==0 )
+	maxrss = usage.ru_maxrss;
+#endif
+    if ( maxrss>=0 )
+	printf( "buildnameslist: %.2f s (%.2f s CPU), peak RSS %ld KB\n", now()-start, (double)(ticks)/CLOCKS_PER_SEC, maxrss );
+    else
+	printf( "buildnameslist: %.2f s (%.2f s CPU)\n", now()-start, (double)(ticks)/CLOCKS_PER_SEC );
+}
+
+#ifdef HAVE_PTHREAD
+struct langjob { int (*fn)(int); int is_fr, ok; };
+
+static void *langthread(void *arg) {
+    struct langjob *job = (struct langjob *)(arg);
+
+    job->ok = job->fn(job->is_fr);
+    return( NULL );
+}
+#endif
+
+/* Run fn() for French and English, at the same time if possible */
+static int bothlangs(int (*fn)(int)) {
+#ifdef HAVE_PTHREAD
+    struct langjob job;
+    pthread_t thread;
+    int ok;
+
+    job.fn = fn; job.is_fr = 1; job.ok = 0;
+    if ( pthread_create(&thread,NULL,langthread,&job)==0 ) {
+	ok = fn(0);
+	pthread_join(thread,NULL);
+	return( ok && job.ok );
+    }
+#endif
+    return( fn(1/*french*/) && fn(0/*english*/) );
 }
 
 int main(int argc, char **argv) {
+    double start = now();
     int errCode=1;
 
     UNUSED_PARAMETER(argc);
     UNUSED_PARAMETER(argv);
-    InitArrays();
-    max_a = max_n = 0;
-    if ( ReadNamesList() && dump(1/*french*/) && dump(0/*english*/) )
+    if ( bothlangs(ReadNamesList) && bothlangs(dump) )
 	errCode=0;
     FreeArrays();
+    report(start);
     return( errCode );
 }
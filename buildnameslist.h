@@ -0,0 +1,2 @@
+const char NL_VERSION[] = "14.0";
+const char NFR_VERSION[] = "14.0";
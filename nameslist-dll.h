@@ -26,10 +26,9 @@
 #endif
 
 #ifdef UNICODE_BLOCK_MAX
-/* Definitions used by nameslist.c for functions{16..21} */
-UN_DLL_LOCAL int uniNamesList_haveFR(unsigned int lang);
-#ifdef WANTLIBOFR
-/* make this visible to nameslist.c if adding French lib */
+#if defined(WANTLIBOFR) && !defined(HAVE_DLOPEN)
+/* Definitions used by nameslist.c for functions{16..21} when there is no */
+/* dlopen() to load the French lib on first use, so it is linked instead */
 extern UN_DLL_IMPORT const char *uniNamesList_NamesListVersionFR(void);
 extern UN_DLL_IMPORT const char *uniNamesList_nameFR(unsigned long uni);
 extern UN_DLL_IMPORT const char *uniNamesList_annotFR(unsigned long uni);
@@ -38,15 +37,13 @@ extern UN_DLL_IMPORT int uniNamesList_blockNumberFR(unsigned long uni);
 extern UN_DLL_IMPORT long uniNamesList_blockStartFR(int uniBlock);
 extern UN_DLL_IMPORT long uniNamesList_blockEndFR(int uniBlock);
 extern UN_DLL_IMPORT const char *uniNamesList_blockNameFR(int uniBlock);
-#else
-/* make these internal stubs since there's no French lib */
-UN_DLL_LOCAL const char *uniNamesList_NamesListVersionFR(void);
-UN_DLL_LOCAL const char *uniNamesList_nameFR(unsigned long uni);
-UN_DLL_LOCAL const char *uniNamesList_annotFR(unsigned long uni);
-UN_DLL_LOCAL int uniNamesList_blockCountFR(void);
-UN_DLL_LOCAL int uniNamesList_blockNumberFR(unsigned long uni);
-UN_DLL_LOCAL long uniNamesList_blockStartFR(int uniBlock);
-UN_DLL_LOCAL long uniNamesList_blockEndFR(int uniBlock);
-UN_DLL_LOCAL const char *uniNamesList_blockNameFR(int uniBlock);
+extern UN_DLL_IMPORT int uniNamesList_nameBatchFR(const uint32_t *uni, size_t count, const char **names);
+extern UN_DLL_IMPORT int uniNamesList_annotBatchFR(const uint32_t *uni, size_t count, const char **annots);
+extern UN_DLL_IMPORT int uniNamesList_blockNumberBatchFR(const uint32_t *uni, size_t count, int *blocks);
+extern UN_DLL_IMPORT int uniNamesList_searchFR(const char *query, int flags, int (*fn)(unsigned long uni, const char *name, void *data), void *data);
+extern UN_DLL_IMPORT int uniNamesList_xrefsFR(unsigned long uni, const uint32_t **out);
+extern UN_DLL_IMPORT int uniNamesList_xrefsBackFR(unsigned long uni, const uint32_t **out);
+extern UN_DLL_IMPORT const char *uniNamesList_annotDisplayFR(unsigned long uni);
+extern UN_DLL_IMPORT long uniNamesList_nextNamedFR(unsigned long uni);
 #endif
 #endif
@@ -0,0 +1 @@
+#define UN_FR_DLNAME "libuninameslist-fr.so.2"
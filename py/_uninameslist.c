@@ -0,0 +1,294 @@
+/* _uninameslist.c - CPython extension used by uninameslist.py
+
+This Python extension is subject to the same "BSD 3-clause"-type license
+which the wrapped C library is subject to.
+
+It gives uninameslist.py the library calls it needs without ctypes, so
+each lookup is one C call returning a str. names(), names2(), annotations()
+and blockNumbers() look up every character of a str in one call and
+return a list. namedChars() skips the unnamed characters of a range in C.
+
+If this does not build, uninameslist.py uses ctypes.
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+#include <uninameslist.h>
+
+#if PY_VERSION_HEX < 0x03030000
+#error "_uninameslist needs Python 3.3 or later, uninameslist.py uses ctypes"
+#endif
+
+/* Characters are looked up in chunks of this many */
+#define CHUNK 256
+/* Size of the character to str cache used by the bulk calls, a power of 2 */
+#define CACHESIZE 256
+
+static PyObject *emptystr;
+
+static int getuni(PyObject *arg, unsigned long *uni) {
+    if ( !PyUnicode_Check(arg) || PyUnicode_GET_LENGTH(arg)!=1 ) {
+	if ( PyUnicode_Check(arg) )
+	    PyErr_Format(PyExc_TypeError, "expected a character, but string of length %zd found", PyUnicode_GET_LENGTH(arg));
+	else
+	    PyErr_Format(PyExc_TypeError, "expected a character, but %.200s found", Py_TYPE(arg)->tp_name);
+	return( 0 );
+    }
+    *uni = PyUnicode_READ_CHAR(arg,0);
+    return( 1 );
+}
+
+static PyObject *fromstr(const char *str) {
+    if ( str==NULL ) {
+	Py_INCREF(emptystr);
+	return( emptystr );
+    }
+    return( PyUnicode_FromString(str) );
+}
+
+/* The normative alias of uni, or its name if it has none */
+static PyObject *fromname2(unsigned long uni) {
+    int i;
+
+    if ( (i=uniNamesList_names2getU(uni))<0 )
+	return( fromstr(uniNamesList_name(uni)) );
+    return( PyUnicode_DecodeUTF8(uniNamesList_names2anC(i),uniNamesList_names2lnC(i),NULL) );
+}
+
+static PyObject *py_name(PyObject *self, PyObject *arg) {
+    unsigned long uni;
+
+    (void)(self);
+    if ( !getuni(arg,&uni) )
+	return( NULL );
+    return( fromstr(uniNamesList_name(uni)) );
+}
+
+static PyObject *py_name2(PyObject *self, PyObject *arg) {
+    unsigned long uni;
+
+    (void)(self);
+    if ( !getuni(arg,&uni) )
+	return( NULL );
+    return( fromname2(uni) );
+}
+
+static PyObject *py_annotation(PyObject *self, PyObject *arg) {
+    unsigned long uni;
+
+    (void)(self);
+    if ( !getuni(arg,&uni) )
+	return( NULL );
+    return( fromstr(uniNamesList_annot(uni)) );
+}
+
+static PyObject *py_valid(PyObject *self, PyObject *arg) {
+    unsigned long uni;
+
+    (void)(self);
+    if ( !getuni(arg,&uni) )
+	return( NULL );
+    return( PyBool_FromLong(uniNamesList_name(uni)!=NULL) );
+}
+
+static PyObject *py_blockNumber(PyObject *self, PyObject *arg) {
+    unsigned long uni;
+
+    (void)(self);
+    if ( !getuni(arg,&uni) )
+	return( NULL );
+    return( PyLong_FromLong(uniNamesList_blockNumber(uni)) );
+}
+
+/* (name, start, end) of block number num, or None */
+static PyObject *py_blockInfo(PyObject *self, PyObject *arg) {
+    const char *name;
+    long num;
+
+    (void)(self);
+    if ( (num=PyLong_AsLong(arg))==-1 && PyErr_Occurred() )
+	return( NULL );
+    if ( num<0 || num>=uniNamesList_blockCount() || (name=uniNamesList_blockName((int)(num)))==NULL )
+	Py_RETURN_NONE;
+    return( Py_BuildValue("(sll)",name,uniNamesList_blockStart((int)(num)),uniNamesList_blockEnd((int)(num))) );
+}
+
+/* The characters with names from start to end, as a str */
+static PyObject *py_namedChars(PyObject *self, PyObject *args) {
+    unsigned long start, end;
+    Py_ssize_t n;
+    Py_UCS4 *buf;
+    PyObject *str;
+    long u;
+
+    (void)(self);
+    if ( !PyArg_ParseTuple(args,"kk",&start,&end) )
+	return( NULL );
+    for ( n=0, u=uniNamesList_nextNamed(start); u>=0 && (unsigned long)(u)<=end; u=uniNamesList_nextNamed((unsigned long)(u)+1) )
+	++n;
+    if ( (buf=PyMem_New(Py_UCS4,n>0 ? n : 1))==NULL )
+	return( PyErr_NoMemory() );
+    for ( n=0, u=uniNamesList_nextNamed(start); u>=0 && (unsigned long)(u)<=end; u=uniNamesList_nextNamed((unsigned long)(u)+1) )
+	buf[n++] = (Py_UCS4)(u);
+    str = PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND,buf,n);
+    PyMem_Free(buf);
+    return( str );
+}
+
+enum bulkwhat { bulk_name, bulk_name2, bulk_annot, bulk_block };
+
+/* Look up each character of str, and return a list of the results */
+static PyObject *bulk(PyObject *arg, enum bulkwhat what) {
+    struct { uint32_t uni; PyObject *obj; } cache[CACHESIZE];
+    const char *strs[CHUNK];
+    uint32_t uni[CHUNK];
+    int blocks[CHUNK];
+    Py_ssize_t len, i, j, n;
+    PyObject *list, *obj;
+    const void *data;
+    unsigned int h;
+    int kind, err;
+
+    if ( !PyUnicode_Check(arg) ) {
+	PyErr_Format(PyExc_TypeError, "expected a string, but %.200s found", Py_TYPE(arg)->tp_name);
+	return( NULL );
+    }
+#if PY_VERSION_HEX < 0x030c0000
+    if ( PyUnicode_READY(arg)<0 )
+	return( NULL );
+#endif
+    len = PyUnicode_GET_LENGTH(arg);
+    kind = PyUnicode_KIND(arg);
+    data = PyUnicode_DATA(arg);
+    if ( (list=PyList_New(len))==NULL )
+	return( NULL );
+    for ( h=0; h<CACHESIZE; ++h ) {
+	cache[h].uni = 0xffffffff;
+	cache[h].obj = NULL;
+    }
+    for ( i=0; i<len; i+=n ) {
+	n = len-i<CHUNK ? len-i : CHUNK;
+	for ( j=0; j<n; ++j )
+	    uni[j] = PyUnicode_READ(kind,data,i+j);
+	if ( what==bulk_block )
+	    err = uniNamesList_blockNumberBatch(uni,(size_t)(n),blocks);
+	else if ( what==bulk_annot )
+	    err = uniNamesList_annotBatch(uni,(size_t)(n),strs);
+	else
+	    err = uniNamesList_nameBatch(uni,(size_t)(n),strs);
+	if ( err<0 ) {
+	    PyErr_NoMemory();
+	    goto fail;
+	}
+	for ( j=0; j<n; ++j ) {
+	    if ( what==bulk_block )
+		obj = PyLong_FromLong(blocks[j]);
+	    else if ( what==bulk_name2 && uniNamesList_names2getU(uni[j])>=0 )
+		obj = fromname2(uni[j]);
+	    else if ( strs[j]==NULL )
+		obj = fromstr(NULL);
+	    else {
+		/* Text repeats characters, so reuse the str made last time. */
+		/* Key on the character, made names are in a reused buffer. */
+		h = uni[j]&(CACHESIZE-1);
+		if ( cache[h].uni!=uni[j] ) {
+		    if ( (obj=fromstr(strs[j]))==NULL )
+			goto fail;
+		    Py_XDECREF(cache[h].obj);
+		    cache[h].uni = uni[j];
+		    cache[h].obj = obj;
+		}
+		obj = cache[h].obj;
+		Py_INCREF(obj);
+	    }
+	    if ( obj==NULL )
+		goto fail;
+	    PyList_SET_ITEM(list,i+j,obj);
+	}
+    }
+    for ( h=0; h<CACHESIZE; ++h )
+	Py_XDECREF(cache[h].obj);
+    return( list );
+
+fail:
+    for ( h=0; h<CACHESIZE; ++h )
+	Py_XDECREF(cache[h].obj);
+    Py_DECREF(list);
+    return( NULL );
+}
+
+static PyObject *py_names(PyObject *self, PyObject *arg) {
+    (void)(self);
+    return( bulk(arg,bulk_name) );
+}
+
+static PyObject *py_names2(PyObject *self, PyObject *arg) {
+    (void)(self);
+    return( bulk(arg,bulk_name2) );
+}
+
+static PyObject *py_annotations(PyObject *self, PyObject *arg) {
+    (void)(self);
+    return( bulk(arg,bulk_annot) );
+}
+
+static PyObject *py_blockNumbers(PyObject *self, PyObject *arg) {
+    (void)(self);
+    return( bulk(arg,bulk_block) );
+}
+
+static PyMethodDef methods[] = {
+    { "name", py_name, METH_O, "returns the Unicode character name" },
+    { "name2", py_name2, METH_O, "returns the Unicode normative alias if defined for correcting a character name, else just the name" },
+    { "annotation", py_annotation, METH_O, "returns all Unicode annotations including aliases and cross-references as provided by NamesList.txt" },
+    { "valid", py_valid, METH_O, "returns whether a character is valid (defined in Unicode)" },
+    { "blockNumber", py_blockNumber, METH_O, "returns the number of the Unicode block a character is in, or -1" },
+    { "blockInfo", py_blockInfo, METH_O, "returns (name, start, end) of a Unicode block number, or None" },
+    { "namedChars", py_namedChars, METH_VARARGS, "returns a string of the characters with names from start to end" },
+    { "names", py_names, METH_O, "returns a list of the Unicode name of each character of a string" },
+    { "names2", py_names2, METH_O, "returns a list of the name2() of each character of a string" },
+    { "annotations", py_annotations, METH_O, "returns a list of the Unicode annotation of each character of a string" },
+    { "blockNumbers", py_blockNumbers, METH_O, "returns a list of the block number of each character of a string" },
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "_uninameslist",
+    "libuninameslist calls for uninameslist.py", -1, methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit__uninameslist(void) {
+    PyObject *m, *chars;
+    Py_UCS4 *buf;
+    int i, n;
+
+    if ( emptystr==NULL && (emptystr=PyUnicode_FromString(""))==NULL )
+	return( NULL );
+    if ( (m=PyModule_Create(&module))==NULL )
+	return( NULL );
+    n = uniNamesList_names2cnt();
+    if ( (buf=PyMem_New(Py_UCS4,n>0 ? n : 1))==NULL ) {
+	PyErr_NoMemory();
+	goto fail;
+    }
+    for ( i=0; i<n; ++i )
+	buf[i] = (Py_UCS4)(uniNamesList_names2val(i));
+    chars = PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND,buf,n);
+    PyMem_Free(buf);
+    if ( chars==NULL )
+	goto fail;
+    if ( PyModule_AddObject(m,"charactersWithName2",chars)<0 ) {
+	Py_DECREF(chars);
+	goto fail;
+    }
+    if ( PyModule_AddStringConstant(m,"version",uniNamesList_NamesListVersion())<0 || \
+	 PyModule_AddIntConstant(m,"blockCount",uniNamesList_blockCount())<0 )
+	goto fail;
+    return( m );
+
+fail:
+    Py_DECREF(m);
+    return( NULL );
+}
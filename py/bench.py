@@ -0,0 +1,65 @@
+# libuninameslist
+#
+# Time the Python wrapper, run using 'make bench'. Prints the same tab
+# separated columns as tests/bench-lookup.c, cycles and misses as '-'.
+# The py.names... lines pass each pattern as one string to the list calls.
+
+import random
+import sys
+import time
+
+import uninameslist
+
+COUNT = 4096
+
+def _codes(pattern):
+    rnd = random.Random(2463534242)
+    if pattern == "sequential":
+        return [chr(c) for c in range(COUNT) if not 0xd800 <= c <= 0xdfff]
+    if pattern == "random":
+        return [chr(c) for c in (rnd.randrange(0x110000) for _ in range(COUNT)) if not 0xd800 <= c <= 0xdfff]
+    if pattern == "ascii":
+        return [chr(0xa0 + rnd.randrange(0x60) if rnd.randrange(16) == 0 else 0x20 + rnd.randrange(0x5f)) for _ in range(COUNT)]
+    if pattern == "cjk":
+        return [chr(0xac00 + rnd.randrange(11172) if rnd.randrange(4) == 0 else 0x4e00 + rnd.randrange(0x5200)) for _ in range(COUNT)]
+    return [chr(0x10000 + rnd.randrange(0x100000)) for _ in range(COUNT)]
+
+PATTERNS = ["sequential", "random", "ascii", "cjk", "supplementary"]
+FUNCTIONS = [("py.name", uninameslist.name),
+             ("py.name2", uninameslist.name2),
+             ("py.annotation", uninameslist.annotation),
+             ("py.block", uninameslist.block)]
+BULK = [("py.names", uninameslist.names),
+        ("py.names2", uninameslist.names2),
+        ("py.annotations", uninameslist.annotations),
+        ("py.blocksOf", uninameslist.blocksOf)]
+
+def _time(fn, secs):
+    reps = 1
+    while True:
+        start = time.perf_counter()
+        for _ in range(reps):
+            fn()
+        elapsed = time.perf_counter() - start
+        if elapsed >= secs or reps >= 1 << 20:
+            return reps, elapsed
+        reps *= 2
+
+def main():
+    secs = float(sys.argv[1]) if len(sys.argv) > 1 else 0.2
+    print("# libuninameslist bench\t{}\tpython {}\t{}".format(uninameslist.version, sys.version.split()[0],
+          "ctypes" if uninameslist._ext is None else "_uninameslist"))
+    print("function\tpattern\tlookups\tns/lookup\tcycles/lookup\tmisses/lookup")
+    for fname, fn in FUNCTIONS + BULK:
+        for pattern in PATTERNS:
+            chars = _codes(pattern)
+            if (fname, fn) in BULK:
+                string = "".join(chars)
+                reps, elapsed = _time(lambda: fn(string), secs)
+            else:
+                reps, elapsed = _time(lambda: [fn(c) for c in chars], secs)
+            lookups = reps * len(chars)
+            print("{}\t{}\t{}\t{:.2f}\t-\t-".format(fname, pattern, lookups, elapsed * 1e9 / lookups))
+
+if __name__ == "__main__":
+    main()
@@ -1,8 +1,13 @@
 #!/usr/bin/env python
 
-from setuptools import setup
+from setuptools import setup, Extension
 import sys
 
+# _uninameslist is optional: if it does not build (no compiler or headers,
+# or python 2), uninameslist.py uses ctypes. Set CFLAGS and LDFLAGS to find
+# uninameslist.h and the library if they are not installed yet.
+ext = Extension('_uninameslist', ['_uninameslist.c'], libraries=['uninameslist'], optional=True)
+
 setup(
     name='uninameslist',
     version='0.2.0',
@@ -22,6 +27,7 @@ setup(
 	'Topic :: Text Processing :: Fonts',
 	'Topic :: Utilities'],
     url='https://github.com/fontforge/libuninameslist/releases/',
-    py_modules=['uninameslist']
+    py_modules=['uninameslist'],
+    ext_modules=[ext]
     )
 
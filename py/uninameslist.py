@@ -19,9 +19,14 @@ This Python wrapper implements:
    version
 4) two convenience functions:
    name2, uplus
+5) four functions taking a string, returning a list for its characters:
+   names, names2, annotations, blocksOf
 
 `version` points to the internal version string of the library.
 Run help() on the rest of the symbols for more info.
+
+The library is called through the _uninameslist extension module if it
+was built by setup.py, else through ctypes.
 '''
 
 
@@ -29,133 +34,220 @@ __all__ = ["version",
            "name", "name2", "charactersWithName2",
            "annotation",
            "block", "blocks",
+           "names", "names2", "annotations", "blocksOf",
            "valid", "uplus"]
 
 
-# connecting to the dynamic library
-
-from ctypes import *
-from ctypes.util import find_library
-_lib = CDLL(find_library("uninameslist"))
-
-def _setSig(fn, restype, argtypes):
-    if restype is not None: fn.restype = restype
-    fn.argtypes = argtypes
-
-# const char *uniNamesList_NamesListVersion(void);
-_setSig(_lib.uniNamesList_NamesListVersion, c_char_p, [])
-# const char *uniNamesList_name(unsigned long uni);
-_setSig(_lib.uniNamesList_name, c_char_p, [c_ulong])
-# const char *uniNamesList_annot(unsigned long uni);
-_setSig(_lib.uniNamesList_annot, c_char_p, [c_ulong])
-# int uniNamesList_blockCount(void);
-_setSig(_lib.uniNamesList_blockCount, c_int, [])
-# int uniNamesList_blockNumber(unsigned long uni);
-_setSig(_lib.uniNamesList_blockNumber, c_int, [c_ulong])
-# long uniNamesList_blockStart(int uniBlock);
-_setSig(_lib.uniNamesList_blockStart, c_long, [c_int])
-# long uniNamesList_blockEnd(int uniBlock);
-_setSig(_lib.uniNamesList_blockEnd, c_long, [c_int])
-# const char *uniNamesList_blockName(int uniBlock);
-_setSig(_lib.uniNamesList_blockName, c_char_p, [c_int])
-
-# int uniNamesList_names2cnt(void);
-_setSig(_lib.uniNamesList_names2cnt, c_int, [])
-# long uniNamesList_names2val(int count);
-_setSig(_lib.uniNamesList_names2val, c_long, [c_int])
-# int uniNamesList_names2getU(unsigned long uni);
-_setSig(_lib.uniNamesList_names2getU, c_int, [c_ulong])
-# int uniNamesList_names2lnC(int count);
-_setSig(_lib.uniNamesList_names2lnC, c_int, [c_int])
-# const char *uniNamesList_names2anC(int count);
-_setSig(_lib.uniNamesList_names2anC, c_char_p, [c_int])
+try:
+    import _uninameslist as _ext
+except ImportError:
+    _ext = None
+
+
+if _ext is not None:
+
+    # using the extension module
+
+    version = _ext.version
+    charactersWithName2 = _ext.charactersWithName2
+    name = _ext.name
+    name2 = _ext.name2
+    annotation = _ext.annotation
+    valid = _ext.valid
+    names = _ext.names
+    names2 = _ext.names2
+    annotations = _ext.annotations
+    _blockNumber = _ext.blockNumber
+    _blockNumbers = _ext.blockNumbers
+    _blockInfo = _ext.blockInfo
+    _blockCount = _ext.blockCount
+    _namedChars = _ext.namedChars
+
+else:
+
+    # connecting to the dynamic library
+
+    from ctypes import *
+    from ctypes.util import find_library
+    _lib = CDLL(find_library("uninameslist"))
+
+    def _setSig(fn, restype, argtypes):
+        if restype is not None: fn.restype = restype
+        fn.argtypes = argtypes
+
+    # const char *uniNamesList_NamesListVersion(void);
+    _setSig(_lib.uniNamesList_NamesListVersion, c_char_p, [])
+    # const char *uniNamesList_name(unsigned long uni);
+    _setSig(_lib.uniNamesList_name, c_char_p, [c_ulong])
+    # const char *uniNamesList_annot(unsigned long uni);
+    _setSig(_lib.uniNamesList_annot, c_char_p, [c_ulong])
+    # int uniNamesList_blockCount(void);
+    _setSig(_lib.uniNamesList_blockCount, c_int, [])
+    # int uniNamesList_blockNumber(unsigned long uni);
+    _setSig(_lib.uniNamesList_blockNumber, c_int, [c_ulong])
+    # long uniNamesList_blockStart(int uniBlock);
+    _setSig(_lib.uniNamesList_blockStart, c_long, [c_int])
+    # long uniNamesList_blockEnd(int uniBlock);
+    _setSig(_lib.uniNamesList_blockEnd, c_long, [c_int])
+    # const char *uniNamesList_blockName(int uniBlock);
+    _setSig(_lib.uniNamesList_blockName, c_char_p, [c_int])
+
+    # int uniNamesList_names2cnt(void);
+    _setSig(_lib.uniNamesList_names2cnt, c_int, [])
+    # long uniNamesList_names2val(int count);
+    _setSig(_lib.uniNamesList_names2val, c_long, [c_int])
+    # int uniNamesList_names2getU(unsigned long uni);
+    _setSig(_lib.uniNamesList_names2getU, c_int, [c_ulong])
+    # int uniNamesList_names2lnC(int count);
+    _setSig(_lib.uniNamesList_names2lnC, c_int, [c_int])
+    # const char *uniNamesList_names2anC(int count);
+    _setSig(_lib.uniNamesList_names2anC, c_char_p, [c_int])
+
+    # long uniNamesList_nextNamed(unsigned long uni);
+    _setSig(_lib.uniNamesList_nextNamed, c_long, [c_ulong])
+
+    '''documents the version of libuninameslist'''
+    version = _lib.uniNamesList_NamesListVersion().decode()
+
+    charactersWithName2 = "".join(chr(_lib.uniNamesList_names2val(i)) for i in range(_lib.uniNamesList_names2cnt()))
+
+    def name(char):
+        '''returns the Unicode character name'''
+        name = _lib.uniNamesList_name(ord(char))
+        return "" if name is None else name.decode()
+
+    def name2(char):
+        '''returns the Unicode normative alias if defined for correcting a character name, else just the name'''
+        name2Index = _lib.uniNamesList_names2getU(ord(char))
+        if name2Index < 0:  # no normative alias
+            return name(char)
+        annotationBytes = _lib.uniNamesList_names2anC(name2Index)
+        normativeAliasLength = _lib.uniNamesList_names2lnC(name2Index)
+        return annotationBytes[:normativeAliasLength].decode()
+
+    def annotation(char):
+        '''returns all Unicode annotations including aliases and cross-references as provided by NamesList.txt'''
+        annot = _lib.uniNamesList_annot(ord(char))
+        return "" if annot is None else annot.decode()
+
+    def valid(char):
+        '''returns whether a character is valid (defined in Unicode)'''
+        return _lib.uniNamesList_name(ord(char)) is not None
+
+    def names(string):
+        '''returns a list of the Unicode name of each character of a string'''
+        return [name(c) for c in string]
+
+    def names2(string):
+        '''returns a list of the name2() of each character of a string'''
+        return [name2(c) for c in string]
+
+    def annotations(string):
+        '''returns a list of the Unicode annotation of each character of a string'''
+        return [annotation(c) for c in string]
+
+    def _blockNumber(char):
+        cp = ord(char)
+        num = _blockIndex[cp >> 4]
+        if num == -2:  # more than one block in these 16
+            return _lib.uniNamesList_blockNumber(cp)
+        if num >= 0 and not _blocks[num].start <= cp <= _blocks[num].end:
+            return -1
+        return num
+
+    def _blockNumbers(string):
+        return [_blockNumber(c) for c in string]
+
+    def _blockInfo(num):
+        if not 0 <= num < _blockCount:
+            return None
+        return (_lib.uniNamesList_blockName(num).decode(),
+                _lib.uniNamesList_blockStart(num),
+                _lib.uniNamesList_blockEnd(num))
+
+    def _namedChars(start, end):
+        # one library call per named character, the others are skipped
+        chars = []
+        cp = _lib.uniNamesList_nextNamed(start)
+        while 0 <= cp <= end:
+            chars.append(chr(cp))
+            cp = _lib.uniNamesList_nextNamed(cp + 1)
+        return "".join(chars)
+
+    _blockCount = _lib.uniNamesList_blockCount()
 
 
 # internal helpers
 
 
 class _block:
-    '''Provides the name, start and end codepoints of a Unicode block and provides iteration over the valid codepoints in it'''
+    '''Provides the name, start and end codepoints of a Unicode block and provides iteration over the valid codepoints in it
+
+    There is one _block for each block, made when the module is loaded, so
+    they can be compared using "is", and they cannot be changed.'''
     __slots__ = ["name", "start", "end"]
 
     def __init__(self, name, start, end):
-        self.name = name; self.start = start; self.end = end
+        object.__setattr__(self, "name", name)
+        object.__setattr__(self, "start", start)
+        object.__setattr__(self, "end", end)
+
+    def __setattr__(self, name, value):
+        raise AttributeError("_block is read only")
 
     def __repr__(self):
         return "<‘{}’: {} - {}>".format(self.name, uplus(self.start), uplus(self.end))
 
     def __iter__(self):
-        for cp in range(self.start, self.end + 1):
-            if _lib.uniNamesList_name(cp) is None:
-                continue
-            yield chr(cp)
+        return iter(_namedChars(self.start, self.end))
 
     @staticmethod
     def _fromNum(num):
-        return _block(_lib.uniNamesList_blockName(num).decode(),
-                      _lib.uniNamesList_blockStart(num),
-                      _lib.uniNamesList_blockEnd(num))
-
-
-_blockCount = _lib.uniNamesList_blockCount()
-
-
-# public symbols
+        return _blocks[num] if -1 <= num < _blockCount else None
 
 
-'''documents the version of libuninameslist'''
-version = _lib.uniNamesList_NamesListVersion().decode()
+# all the blocks by number, with None last so _blocks[-1] is None
+_blocks = tuple(_block(*_blockInfo(num)) for num in range(_blockCount)) + (None,)
+_blocksByName = dict((b.name.upper(), b) for b in _blocks[:-1])
 
 
-def name(char):
-    '''returns the Unicode character name'''
-    name = _lib.uniNamesList_name(ord(char))
-    return "" if name is None else name.decode()
+if _ext is None:
+    # block number for each 16 codepoints, -2 if more than one block
+    # starts or ends in them, so _blockNumber() needs no library call.
+    from array import array
+    _blockIndex = array("h", [-1]) * (0x110000 >> 4)
+    for _num in range(_blockCount):
+        for _i in range(_blocks[_num].start >> 4, (_blocks[_num].end >> 4) + 1):
+            _blockIndex[_i] = _num if _blockIndex[_i] == -1 else -2
+    del _num, _i
 
 
-def name2(char):
-    '''returns the Unicode normative alias if defined for correcting a character name, else just the name'''
-    name2Index = _lib.uniNamesList_names2getU(ord(char))
-    if name2Index < 0:  # no normative alias
-        return name(char)
-    annotationBytes = _lib.uniNamesList_names2anC(name2Index)
-    normativeAliasLength = _lib.uniNamesList_names2lnC(name2Index)
-    return annotationBytes[:normativeAliasLength].decode()
-
-
-def annotation(char):
-    '''returns all Unicode annotations including aliases and cross-references as provided by NamesList.txt'''
-    annot = _lib.uniNamesList_annot(ord(char))
-    return "" if annot is None else annot.decode()
+# public symbols
 
 
 def blocks():
     '''a generator for iterating through all defined Unicode blocks'''
     for blockNum in range(_blockCount):
-        yield _block._fromNum(blockNum)
+        yield _blocks[blockNum]
 
 
 def block(char):
     '''returns the Unicode block a character is in, or by block name'''
     if len(char) == 1:
-        return _block._fromNum(_lib.uniNamesList_blockNumber(ord(char)))
+        return _blocks[_blockNumber(char)]
     else:  # assuming input is a block name
         name = char.upper()
-        for b in blocks():
-            if b.name.upper() == name:
-                return b
+        if name in _blocksByName:
+            return _blocksByName[name]
         raise ValueError("Invalid Unicode block name: ‘{}’".format(name))
 
 
-# apart from what C library provides
+def blocksOf(string):
+    '''returns a list of the Unicode block of each character of a string, None if it has no block'''
+    return [_blocks[num] for num in _blockNumbers(string)]
 
 
-charactersWithName2 = "".join(chr(_lib.uniNamesList_names2val(i)) for i in range(_lib.uniNamesList_names2cnt()))
-
-
-def valid(char):
-    '''returns whether a character is valid (defined in Unicode)'''
-    return _lib.uniNamesList_name(ord(char)) is not None
+# apart from what C library provides
 
 
 def uplus(char):
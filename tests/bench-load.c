@@ -0,0 +1,231 @@
+/* bench-load.c - Time loading libuninameslist, run using 'make bench'
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+For each library given, this shows what it costs a new process to use
+it: the time for dlopen() and the first uniNamesList_name() call (each
+in a new forked process), the number of dynamic relocations, and the
+resident, shared and dirty memory of the library after looking up N
+random unicode values. One tab separated line is printed per value.
+
+Usage: bench-load [-n N] library...	N defaults to 1000
+*/
+
+#define _GNU_SOURCE 1
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#ifdef HAVE_DL_ITERATE_PHDR
+#include <link.h>
+#endif
+
+#define LOADRUNS 21
+
+typedef const char *(*namefn)(unsigned long uni);
+
+static double now(void) {
+#ifdef HAVE_CLOCK_GETTIME
+    struct timespec ts;
+
+    if ( clock_gettime(CLOCK_MONOTONIC,&ts)==0 )
+	return( (double)(ts.tv_sec)+(double)(ts.tv_nsec)*1e-9 );
+#endif
+    return( (double)(clock())/CLOCKS_PER_SEC );
+}
+
+/* The English library has uniNamesList_name(), the French one has ...FR() */
+static namefn findname(void *lib) {
+    void *fn;
+
+    if ( (fn=dlsym(lib,"uniNamesList_name"))==NULL )
+	fn = dlsym(lib,"uniNamesList_nameFR");
+    return( (namefn)(uintptr_t)(fn) );
+}
+
+/* Load the library in a new process, return {dlopen,first call} seconds */
+static int loadonce(const char *path, int flags, double *t) {
+    int fd[2], status;
+    ssize_t got;
+    pid_t pid;
+    void *lib;
+    namefn fn;
+    double s;
+
+    if ( pipe(fd)!=0 || (pid=fork())<0 )
+	return( 0 );
+    if ( pid==0 ) {
+	close(fd[0]);
+	s = now();
+	lib = dlopen(path,flags);
+	t[0] = now()-s;
+	if ( lib==NULL || (fn=findname(lib))==NULL )
+	    _exit(1);
+	s = now();
+	if ( fn(0x41)==NULL )
+	    _exit(1);
+	t[1] = now()-s;
+	_exit( write(fd[1],t,2*sizeof(double))==(ssize_t)(2*sizeof(double)) ? 0 : 1 );
+    }
+    close(fd[1]);
+    got = read(fd[0],t,2*sizeof(double));
+    close(fd[0]);
+    if ( waitpid(pid,&status,0)!=pid || !WIFEXITED(status) || WEXITSTATUS(status)!=0 )
+	return( 0 );
+    /* a short read would leave the times of the last run in t */
+    return( got==(ssize_t)(2*sizeof(double)) );
+}
+
+static int cmpdouble(const void *a, const void *b) {
+    double da = *(const double *)(a), db = *(const double *)(b);
+    return( da<db ? -1 : da>db );
+}
+
+static void benchload(const char *name, const char *path, int flags, const char *mode) {
+    double t[2], open[LOADRUNS], call[LOADRUNS];
+    int i;
+
+    for ( i=0; i<LOADRUNS; ++i ) {
+	if ( !loadonce(path,flags,t) ) {
+	    fprintf( stderr, "Cannot load %s\n", path );
+	    return;
+	}
+	open[i] = t[0]; call[i] = t[1];
+    }
+    qsort(open,LOADRUNS,sizeof(double),cmpdouble);
+    qsort(call,LOADRUNS,sizeof(double),cmpdouble);
+    printf( "%s\tdlopen_%s_ns_min\t%.0f\n", name, mode, open[0]*1e9 );
+    printf( "%s\tdlopen_%s_ns_median\t%.0f\n", name, mode, open[LOADRUNS/2]*1e9 );
+    printf( "%s\tfirstcall_%s_ns_min\t%.0f\n", name, mode, call[0]*1e9 );
+    printf( "%s\tfirstcall_%s_ns_median\t%.0f\n", name, mode, call[LOADRUNS/2]*1e9 );
+}
+
+#ifdef HAVE_DL_ITERATE_PHDR
+/* Count relocations from the dynamic section of the loaded library */
+struct reloccount {
+    const char *name;
+    unsigned long rela, relaent, rel, relent, plt, relative, relr;
+    int found;
+};
+
+static int countrelocs(struct dl_phdr_info *info, size_t size, void *data) {
+    struct reloccount *rc = (struct reloccount *)(data);
+    const ElfW(Dyn) *dyn;
+    int i;
+
+    (void)(size);
+    if ( info->dlpi_name==NULL || strstr(info->dlpi_name,rc->name)==NULL )
+	return( 0 );
+    for ( i=0; i<info->dlpi_phnum; ++i ) if ( info->dlpi_phdr[i].p_type==PT_DYNAMIC ) {
+	dyn = (const ElfW(Dyn) *)(info->dlpi_addr+info->dlpi_phdr[i].p_vaddr);
+	for ( ; dyn->d_tag!=DT_NULL; ++dyn ) switch ( dyn->d_tag ) {
+	  case DT_RELASZ: rc->rela = dyn->d_un.d_val; break;
+	  case DT_RELAENT: rc->relaent = dyn->d_un.d_val; break;
+	  case DT_RELSZ: rc->rel = dyn->d_un.d_val; break;
+	  case DT_RELENT: rc->relent = dyn->d_un.d_val; break;
+	  case DT_PLTRELSZ: rc->plt = dyn->d_un.d_val; break;
+	  case DT_RELACOUNT: case DT_RELCOUNT: rc->relative += dyn->d_un.d_val; break;
+#ifdef DT_RELRSZ
+	  case DT_RELRSZ: rc->relr = dyn->d_un.d_val; break;
+#endif
+	  default: break;
+	}
+	rc->found = 1;
+    }
+    return( rc->found );
+}
+
+static void benchrelocs(const char *name) {
+    struct reloccount rc;
+    unsigned long ent;
+
+    memset(&rc,0,sizeof(rc));
+    rc.name = name;
+    if ( !dl_iterate_phdr(countrelocs,&rc) )
+	return;
+    ent = rc.relaent!=0 ? rc.relaent : rc.relent!=0 ? rc.relent : sizeof(ElfW(Rela));
+    printf( "%s\trelocs\t%lu\n", name, (rc.relaent!=0 ? rc.rela/rc.relaent : 0) +
+	    (rc.relent!=0 ? rc.rel/rc.relent : 0) + rc.plt/ent );
+    printf( "%s\trelocs_relative\t%lu\n", name, rc.relative );
+    printf( "%s\trelocs_plt\t%lu\n", name, rc.plt/ent );
+    if ( rc.relr>0 )
+	printf( "%s\trelr_bytes\t%lu\n", name, rc.relr );
+}
+#endif
+
+/* Sum the memory of the mappings of the library from /proc/self/smaps */
+static void benchmemory(const char *name) {
+    static const char *fields[] = { "Rss", "Shared_Clean", "Shared_Dirty", "Private_Clean", "Private_Dirty", NULL };
+    unsigned long kb[5] = { 0 }, v;
+    char line[512], field[64];
+    FILE *smaps;
+    int i, inlib=0, any=0;
+
+    if ( (smaps=fopen("/proc/self/smaps","r"))==NULL )
+	return;
+    while ( fgets(line,sizeof(line),smaps)!=NULL ) {
+	if ( sscanf(line,"%lx-%lx ",&v,&v)==2 ) {
+	    /* A new mapping, with the file name last */
+	    inlib = strstr(line,name)!=NULL;
+	    any |= inlib;
+	} else if ( inlib && sscanf(line,"%63[^:]: %lu kB",field,&v)==2 ) {
+	    for ( i=0; fields[i]!=NULL; ++i )
+		if ( strcmp(field,fields[i])==0 ) kb[i] += v;
+	}
+    }
+    fclose(smaps);
+    if ( !any )
+	return;
+    for ( i=0; fields[i]!=NULL; ++i )
+	printf( "%s\t%s_kB\t%lu\n", name, fields[i], kb[i] );
+}
+
+int main(int argc, char **argv) {
+    const char *name;
+    uint32_t seed = 2463534242u;
+    int i, a, n=1000;
+    void *lib;
+    namefn fn;
+
+    printf( "# libuninameslist load bench\n" );
+    printf( "library\tmetric\tvalue\n" );
+    for ( a=1; a<argc; ++a ) {
+	if ( strcmp(argv[a],"-n")==0 && a+1<argc ) {
+	    n = atoi(argv[++a]);
+    continue;
+	}
+	name = strrchr(argv[a],'/')!=NULL ? strrchr(argv[a],'/')+1 : argv[a];
+	benchload(name,argv[a],RTLD_LAZY,"lazy");
+	benchload(name,argv[a],RTLD_NOW,"now");
+
+	/* Then load it here, and look at it after n lookups */
+	if ( (lib=dlopen(argv[a],RTLD_NOW))==NULL || (fn=findname(lib))==NULL ) {
+	    fprintf( stderr, "Cannot load %s\n", argv[a] );
+	    return( 1 );
+	}
+#ifdef HAVE_DL_ITERATE_PHDR
+	benchrelocs(name);
+#endif
+	for ( i=0; i<n; ++i ) {
+	    seed ^= seed<<13; seed ^= seed>>17; seed ^= seed<<5;
+	    fn(seed%0x110000);
+	}
+	printf( "%s\ttouched\t%d\n", name, n );
+	benchmemory(name);
+	dlclose(lib);
+    }
+    return( 0 );
+}
@@ -0,0 +1,298 @@
+/* bench-lookup.c - Time libuninameslist lookups, run using 'make bench'
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+Each lookup function is run over arrays of unicode values chosen in
+several ways, and one line is printed for each function and array, as
+tab separated values so that results can be kept and compared between
+releases. Cycles and cache misses are counted using perf_event_open()
+where it exists and is allowed, else they are shown as "-".
+
+Usage: bench-lookup [seconds]	time spent on each line, default 0.2
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "uninameslist.h"
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define BENCHCNT 65536
+
+static uint32_t codes[BENCHCNT];
+static const char *strs[BENCHCNT];
+static int blocks[BENCHCNT];
+static char names[BENCHCNT][UNICODE_NAME_MAX+1];
+static struct unicode_names *datafile;
+static volatile uintptr_t sink;
+
+/* Access patterns, filling codes[] */
+static uint32_t seed = 2463534242u;
+
+static uint32_t xorshift(void) {
+    seed ^= seed<<13; seed ^= seed>>17; seed ^= seed<<5;
+    return( seed );
+}
+
+/* Named values, leaving out the Hangul, CJK and Tangut ranges whose names */
+/* are made from the value, so that names come from the tables */
+static uint32_t named[BENCHCNT], namedcnt;
+
+static void fillnamed(void) {
+    long u;
+
+    for ( u=uniNamesList_nextNamed(0); u>=0 && namedcnt<BENCHCNT; u=uniNamesList_nextNamed((unsigned long)(u)+1) )
+	if ( !(u>=0x3400 && u<=0x9fff) && !(u>=0xac00 && u<=0xd7a3) && !(u>=0x17000 && u<=0x18cff) && \
+	     !(u>=0x20000 && u<=0x3ffff) )
+	    named[namedcnt++] = (uint32_t)(u);
+}
+
+static void fillcodes(int pattern) {
+    uint32_t i, r;
+
+    seed = 2463534242u;
+    for ( i=0; i<BENCHCNT; ++i ) {
+	r = xorshift();
+	switch ( pattern ) {
+	  case 0:		/* sequential through the BMP */
+	    codes[i] = i;
+	  break;
+	  case 1:		/* anywhere */
+	    codes[i] = r%0x110000;
+	  break;
+	  case 2:		/* mostly ASCII text, some Latin-1 */
+	    codes[i] = (r&15)==0 ? 0xa0+(r>>4)%0x60 : 0x20+(r>>4)%0x5f;
+	  break;
+	  case 3:		/* CJK unified ideographs and Hangul */
+	    codes[i] = (r&3)==0 ? 0xac00+(r>>2)%11172 : 0x4e00+(r>>2)%0x5200;
+	  break;
+	  case 4:		/* anywhere with a name in the tables */
+	    codes[i] = namedcnt>0 ? named[r%namedcnt] : 0x41;
+	  break;
+	  default:		/* supplementary planes */
+	    codes[i] = 0x10000+r%0x100000;
+	  break;
+	}
+    }
+}
+
+static const char *patterns[] = { "sequential", "random", "ascii", "cjk", "named", "supplementary", NULL };
+
+/* Functions to time, each does BENCHCNT lookups of codes[] */
+static void bname(void) {
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) strs[i] = uniNamesList_name(codes[i]);
+}
+
+/* Names used, like building an index of them */
+static void bnameLen(void) {
+    const char *pt;
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) blocks[i] = (pt=uniNamesList_name(codes[i]))!=NULL ? (int)(strlen(pt)) : 0;
+}
+
+static void bannot(void) {
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) strs[i] = uniNamesList_annot(codes[i]);
+}
+
+static void bblocknumber(void) {
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) blocks[i] = uniNamesList_blockNumber(codes[i]);
+}
+
+static void bnames2getU(void) {
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) blocks[i] = uniNamesList_names2getU(codes[i]);
+}
+
+static void bnameAlt0(void) {
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) strs[i] = uniNamesList_nameAlt(codes[i],0);
+}
+
+static void bnameAlt1(void) {
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) strs[i] = uniNamesList_nameAlt(codes[i],1);
+}
+
+static void bnameBoth(void) {
+    const char *str1;
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) uniNamesList_nameBoth(codes[i],1,&strs[i],&str1);
+}
+
+static void bblockNumberBoth(void) {
+    int i, bn1;
+    for ( i=0; i<BENCHCNT; ++i ) uniNamesList_blockNumberBoth(codes[i],1,&blocks[i],&bn1);
+}
+
+static void bnameBatch(void) {
+    uniNamesList_nameBatch(codes,BENCHCNT,strs);
+}
+
+static void bblockNumberBatch(void) {
+    uniNamesList_blockNumberBatch(codes,BENCHCNT,blocks);
+}
+
+static void bcodepoint(void) {
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) if ( names[i][0]!='\0' ) blocks[i] = (int)(uniNamesList_codepoint(names[i]));
+}
+
+static void bnameFile(void) {
+    int i;
+    for ( i=0; i<BENCHCNT; ++i ) strs[i] = uniNamesList_nameFile(codes[i],datafile);
+}
+
+static const struct benchfn {
+    const char *name;
+    void (*fn)(void);
+} benchfns[] = {
+    { "name", bname },
+    { "nameLen", bnameLen },
+    { "annot", bannot },
+    { "blockNumber", bblocknumber },
+    { "names2getU", bnames2getU },
+    { "nameAlt.0", bnameAlt0 },
+    { "nameAlt.1", bnameAlt1 },
+    { "nameBoth", bnameBoth },
+    { "blockNumberBoth", bblockNumberBoth },
+    { "nameBatch", bnameBatch },
+    { "blockNumberBatch", bblockNumberBatch },
+    { "codepoint", bcodepoint },
+    { "nameFile", bnameFile },
+    { NULL, NULL }
+};
+
+/* Hardware counters, -1 if they cannot be read */
+static int perfopen(int config) {
+#ifdef HAVE_LINUX_PERF_EVENT_H
+    struct perf_event_attr attr;
+
+    memset(&attr,0,sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config==0 ? PERF_COUNT_HW_CPU_CYCLES : PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return( (int)(syscall(SYS_perf_event_open,&attr,0,-1,-1,0)) );
+#else
+    (void)(config);
+    return( -1 );
+#endif
+}
+
+static void perfstart(const int *fd) {
+#ifdef HAVE_LINUX_PERF_EVENT_H
+    int i;
+    for ( i=0; i<2; ++i ) if ( fd[i]>=0 ) {
+	ioctl(fd[i],PERF_EVENT_IOC_RESET,0);
+	ioctl(fd[i],PERF_EVENT_IOC_ENABLE,0);
+    }
+#else
+    (void)(fd);
+#endif
+}
+
+static void perfstop(const int *fd, double *count) {
+    int i;
+
+    for ( i=0; i<2; ++i ) {
+	count[i] = -1;
+#ifdef HAVE_LINUX_PERF_EVENT_H
+	if ( fd[i]>=0 ) {
+	    uint64_t c;
+	    ioctl(fd[i],PERF_EVENT_IOC_DISABLE,0);
+	    if ( read(fd[i],&c,sizeof(c))==(ssize_t)(sizeof(c)) )
+		count[i] = (double)(c);
+	}
+#endif
+    }
+}
+
+static double now(void) {
+#ifdef HAVE_CLOCK_GETTIME
+    struct timespec ts;
+
+    if ( clock_gettime(CLOCK_MONOTONIC,&ts)==0 )
+	return( (double)(ts.tv_sec)+(double)(ts.tv_nsec)*1e-9 );
+#endif
+    return( (double)(clock())/CLOCKS_PER_SEC );
+}
+
+static void printcount(double count, double lookups) {
+    if ( count<0 )
+	printf( "\t-" );
+    else
+	printf( "\t%.2f", count/lookups );
+}
+
+int main(int argc, char **argv) {
+    const struct benchfn *b;
+    double secs=0.2, start, t, lookups, count[2];
+    char path[1024];
+    const char *srcdir;
+    int p, i, reps, fd[2];
+
+    if ( argc>1 && (secs=atof(argv[1]))<=0 )
+	secs = 0.2;
+    /* uniNamesList_nameFile() uses the data file next to the library source */
+    if ( (srcdir=getenv("srcdir"))==NULL ) srcdir = ".";
+    snprintf(path,sizeof(path),"%s/../nameslist.dat",srcdir);
+    datafile = uniNamesList_open(path);
+    fd[0] = perfopen(0); fd[1] = perfopen(1);
+    fillnamed();
+
+    printf( "# libuninameslist bench\t%s\t%s\n", uniNamesList_NamesListVersion(),
+	    uniNamesList_NamesListVersionAlt(1)!=NULL ? uniNamesList_NamesListVersionAlt(1) : "no French" );
+    printf( "function\tpattern\tlookups\tns/lookup\tcycles/lookup\tmisses/lookup\n" );
+    for ( b=benchfns; b->name!=NULL; ++b ) {
+	if ( b->fn==bnameFile && datafile==NULL )
+    continue;
+	for ( p=0; patterns[p]!=NULL; ++p ) {
+	    fillcodes(p);
+	    for ( i=0; i<BENCHCNT; ++i )
+		if ( uniNamesList_nameBuf(codes[i],names[i],sizeof(names[i]))<0 ) names[i][0] = '\0';
+	    /* Warm up, then double the repeats until it takes long enough */
+	    b->fn();
+	    for ( reps=1; ; reps*=2 ) {
+		perfstart(fd);
+		start = now();
+		for ( i=0; i<reps; ++i )
+		    b->fn();
+		t = now()-start;
+		perfstop(fd,count);
+		if ( t>=secs || reps>=(1<<20) )
+	    break;
+	    }
+	    sink += (uintptr_t)(strs[0])+(uintptr_t)(blocks[0]);
+	    lookups = (double)(reps)*BENCHCNT;
+	    printf( "%s\t%s\t%.0f\t%.2f", b->name, patterns[p], lookups, t*1e9/lookups );
+	    printcount(count[0],lookups);
+	    printcount(count[1],lookups);
+	    printf( "\n" );
+	}
+    }
+#ifdef HAVE_LINUX_PERF_EVENT_H
+    for ( i=0; i<2; ++i ) if ( fd[i]>=0 ) close(fd[i]);
+#endif
+    uniNamesList_close(datafile);
+    return( 0 );
+}
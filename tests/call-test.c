@@ -18,9 +18,17 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
 
 */
 
+#ifdef DO_CALL_TEST21
+/* Build the library in, to count the codes a search makes names for */
+static unsigned long range_visits;
+#define UN_RANGE_VISIT(u)	(++range_visits)
+#include "nameslist.c"
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <ctype.h>
 #include "call-test.h"
 #if defined(DO_CALL_TEST3) || defined(DO_CALL_TEST4)
 #include "uninameslist-fr.h"
@@ -30,7 +38,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
 #include "uninameslist-fr.h"
 #endif
 #endif
+#if defined(DO_CALL_TEST19) && defined(HAVE_DLOPEN)
+#include <dlfcn.h>
+#include "nameslist-lang.h"
+#endif
 
+#if defined(DO_CALL_TEST0) || defined(DO_CALL_TEST1) || defined(DO_CALL_TEST2) || defined(DO_CALL_TEST3) || \
+    defined(DO_CALL_TEST4) || defined(DO_CALL_TEST5) || defined(DO_CALL_TEST6) || defined(DO_CALL_TEST7) || \
+    defined(DO_CALL_TEST12)
 static const char NOTCMP[]="Annotation can vary, check to exist, string not compared";
 static const char NOBLKT[]="Block Names can vary, check to exist, string not compared";
 
@@ -59,6 +74,7 @@ static int test(long val, const char *result, const char *expect) {
     printf("\n  ret=\"%s\"\n  exp=\"%s\"\n",result,expect);
     return( (int)(strcmp(result,expect)==0 || NOTCMP==expect || (NOBLKT==expect ? 1:0)) );
 }
+#endif
 
 #if defined(DO_CALL_TEST0) || defined(DO_CALL_TEST3)
 static const char *test_name(unsigned long uni) {
@@ -76,6 +92,15 @@ static const char *test_annot(unsigned long uni) {
 }
 #endif
 
+#if defined(DO_CALL_TEST7) || defined(DO_CALL_TEST9) || defined(DO_CALL_TEST10) || defined(DO_CALL_TEST11)
+/* Names may be decoded into buffers, so compare the strings, not pointers */
+static int same(const char *a, const char *b) {
+    if ( a==NULL || b==NULL )
+	return( a==b );
+    return( strcmp(a,b)==0 );
+}
+
+#endif
 #ifdef DO_CALL_TEST0
 static int test_calls_2012(void) {
 /* Verify backwards compatibility for older programs. */
@@ -125,7 +150,8 @@ static int test_calls_03(void) {
 
 #ifdef DO_CALL_TEST2
 static int test_calls_04(void) {
-    int ret;
+    unsigned long u;
+    int i, ret;
 
     ret = uniNamesList_blockCount();
     printf("test, return=%d=uniNamesList_blockCount(void);\n",ret);
@@ -157,6 +183,16 @@ static int test_calls_04(void) {
 	return( -3 );
     }
 
+    /* block index must agree with a search of the block list */
+    for ( u=0; u<0x110000; ++u ) {
+	for ( i=0; i<ret && (unsigned long)(uniNamesList_blockEnd(i))<u; ++i );
+	if ( i==ret || (unsigned long)(uniNamesList_blockStart(i))>u ) i = -1;
+	if ( uniNamesList_blockNumber(u)!=i ) {
+	    printf("error with uniNamesList_blockNumber(U+%04lX), expected %d\n", u, i );
+	    return( -4 );
+	}
+    }
+
     return( 0 );
 }
 #endif
@@ -270,13 +306,33 @@ static int test_normalize(void) {
 	return( -4 );
     }
 
+    /* every unicode value finds its own place in the names2 list */
+    for ( u=c=0; u<=0x110000; ++u ) {
+	if ( (a=uniNamesList_names2getU((unsigned long)(u)))<0 ) continue;
+	if ( a!=c++ || uniNamesList_names2val(a)!=u || \
+	     uniNamesList_names2anU((unsigned long)(u))!=uniNamesList_names2anC(a) ) break;
+    }
+    if ( u<=0x110000 || c!=uniNamesList_names2cnt() ) {
+	printf("error with uniNamesList_names2getU(0x%04lX)\n", u );
+	return( -5 );
+    }
+
     return( 0 );
 }
 #endif
 
+#if defined(DO_CALL_TEST7) || defined(DO_CALL_TEST13)
+static int found_first(unsigned long uni, const char *name, void *data) {
+    (void)(name);
+    *(unsigned long *)(data) = uni;
+    return( 1 );
+}
+#endif
+
 #ifdef DO_CALL_TEST7
 static int test_calls_07(void) {
     const char *cc0, *cc1;
+    unsigned long u;
     int n0, n1;
 
     if ( test(0,uniNamesList_Languages(0),"EN") && \
@@ -409,11 +465,904 @@ static int test_calls_07(void) {
 	printf("error with uniNamesList_blockNumberBoth(code,lang,&n0=%d,&n1=%d)\n",n0,n1);
 	return( -11 );
     }
+
+    {
+	const uint32_t uni[3] = { 0x41, 0xE9, 0x300000 };
+	const char *names[3];
+	int blocks[3];
+
+	if ( uniNamesList_nameBatchAlt(uni,3,1,names)==0 && \
+	     same(names[0],uniNamesList_nameAlt(0x41,1)) && \
+	     same(names[1],uniNamesList_nameAlt(0xE9,1)) && names[2]==NULL && \
+	     uniNamesList_blockNumberBatchAlt(uni,3,1,blocks)==0 && \
+	     uniNamesList_blockNumberBoth(0xE9,1,&n0,&n1)==0 && \
+	     blocks[1]==n1 && blocks[2]==-1 )
+	    ;
+	else {
+	    printf("error with uniNamesList_*BatchAlt(uni,count,lang)\n");
+	    return( -12 );
+	}
+    }
+    if ( uniNamesList_searchAlt("lettre minuscule latine a",UN_SEARCH_WORDS,1,found_first,&u)!=1 || \
+	 u!=0x61 ) {
+	printf("error with uniNamesList_searchAlt(query,flags,lang,fn,data)\n");
+	return( -13 );
+    }
     printf("done\n" );
     return( 0 );
 }
 #endif
 
+#ifdef DO_CALL_TEST8
+static int test_codepoint(void) {
+    unsigned long u;
+    const char *pt;
+
+    if ( uniNamesList_codepoint(NULL)==-1 && \
+	 uniNamesList_codepoint("")==-1 && \
+	 uniNamesList_codepoint("NOT A CHARACTER NAME")==-1 && \
+	 uniNamesList_codepoint("space")==-1 && \
+	 uniNamesList_codepoint("SPACE")==32 && \
+	 uniNamesList_codepoint("LATIN SMALL LETTER A WITH ACUTE")==0xE1 && \
+	 uniNamesList_codepoint("TOP HAT")==0x1F3A9 && \
+	 uniNamesList_codepointLen("TOP HATS",7)==0x1F3A9 && \
+	 uniNamesList_codepointLen("TOP HAT",6)==-1 )
+	;
+    else {
+	printf("error with uniNamesList_codepoint(name)\n");
+	return( -1 );
+    }
+
+    /* every name must map back to its own unicode value */
+    for ( u=0; u<0x110000; ++u ) {
+	if ( (pt=uniNamesList_name(u))!=NULL && uniNamesList_codepoint(pt)!=(long)(u) ) {
+	    printf("error with uniNamesList_codepoint(\"%s\"), expected U+%04lX\n", pt, u );
+	    return( -2 );
+	}
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST9
+static int test_batch(void) {
+    uint32_t uni[1024];
+    const char *names[1024], *annots[1024];
+    int blocks[1024];
+    unsigned long u;
+    size_t i, n;
+
+    if ( uniNamesList_nameBatch(NULL,1,names)!=-1 || \
+	 uniNamesList_nameBatch(uni,0,NULL)!=0 ) {
+	printf("error with uniNamesList_nameBatch() arguments\n");
+	return( -1 );
+    }
+
+    /* batch results must match single lookups, including bad values */
+    for ( u=0; u<0x110400; u+=n ) {
+	for ( i=n=0; i<1024; ++i, ++n )
+	    uni[i] = (uint32_t)(u+i);
+	uni[0] = 0xFFFFFFFFu;
+	if ( uniNamesList_nameBatch(uni,n,names)!=0 || \
+	     uniNamesList_annotBatch(uni,n,annots)!=0 || \
+	     uniNamesList_blockNumberBatch(uni,n,blocks)!=0 ) {
+	    printf("error with uniNamesList_*Batch() at U+%04lX\n", u );
+	    return( -2 );
+	}
+	for ( i=0; i<n; ++i ) {
+	    if ( !same(names[i],uniNamesList_name(uni[i])) || \
+		 annots[i]!=uniNamesList_annot(uni[i]) || \
+		 blocks[i]!=uniNamesList_blockNumber(uni[i]) ) {
+		printf("error with uniNamesList_*Batch() for U+%04lX\n", (unsigned long)(uni[i]) );
+		return( -3 );
+	    }
+	}
+	if ( uniNamesList_nameBatchAlt(uni,n,0,names)!=0 || \
+	     uniNamesList_annotBatchAlt(uni,n,0,annots)!=0 || \
+	     uniNamesList_blockNumberBatchAlt(uni,n,0,blocks)!=0 ) {
+	    printf("error with uniNamesList_*BatchAlt() at U+%04lX\n", u );
+	    return( -4 );
+	}
+	for ( i=0; i<n; ++i ) {
+	    if ( !same(names[i],uniNamesList_nameAlt(uni[i],0)) || \
+		 annots[i]!=uniNamesList_annotAlt(uni[i],0) || \
+		 blocks[i]!=uniNamesList_blockNumber(uni[i]) ) {
+		printf("error with uniNamesList_*BatchAlt() for U+%04lX\n", (unsigned long)(uni[i]) );
+		return( -5 );
+	    }
+	}
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST10
+static unsigned long text_next;
+
+static int text_check(const struct unicode_text *t, void *data) {
+    /* every unicode value, except surrogates, is given once in order */
+    if ( text_next==0xD800 ) text_next=0xE000;
+    if ( t->uni!=text_next || !same(t->name,uniNamesList_name(t->uni)) || \
+	 t->block!=uniNamesList_blockNumber(t->uni) ) {
+	printf("error with uniNamesList_text*Call() at U+%04lX\n", text_next );
+	return( 1 );
+    }
+    ++text_next;
+    (void)(data);
+    return( 0 );
+}
+
+static int text_keep(const struct unicode_text *t, void *data) {
+    uint32_t *got=(uint32_t *)(data);
+
+    /* got[0] counts, and the first 3 unicode values follow */
+    if ( got[0]<3 ) got[1+got[0]]=t->uni;
+    ++got[0];
+    return( 0 );
+}
+
+static int test_text(void) {
+    const char bad[] = "\xC0\xAF" "a" "\xE0\x80" "\xED\xA0\x80" "\xF0\x9F\x98";
+    const uint16_t bad16[] = { 0x41, 0xDC00, 0xD83D, 0x42, 0xD83D, 0xDE00 };
+    const uint32_t expect[] = { 0xFFFD, 0xFFFD, 'a', 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD };
+    struct unicode_text t[16];
+    uint32_t got[4] = { 0 };
+    unsigned char *buf;
+    uint16_t *buf16;
+    unsigned long u;
+    size_t i, n, used;
+
+    n=uniNamesList_textUTF8("A\xC3\xA9 \xF0\x9F\x98\x80 hello, world.",22,t,16,&used);
+    if ( n!=16 || used!=20 || t[0].uni!=0x41 || t[1].uni!=0xE9 || t[1].offset!=1 || \
+	 t[3].uni!=0x1F600 || t[3].offset!=4 || t[4].offset!=8 || t[15].uni!='l' || \
+	 strcmp(t[1].name,"LATIN SMALL LETTER E WITH ACUTE")!=0 || t[2].block!=0 || \
+	 t[3].block!=uniNamesList_blockNumber(0x1F600) || t[15].offset!=19 ) {
+	printf("error with uniNamesList_textUTF8()\n");
+	return( -1 );
+    }
+
+    /* malformed sequences are replaced by U+FFFD for each maximal subpart, */
+    /* except the sequence cut at the end, which is left for the next call */
+    n=uniNamesList_textUTF8(bad,sizeof(bad)-1,t,16,&used);
+    if ( n!=8 || used!=sizeof(bad)-4 ) {
+	printf("error with uniNamesList_textUTF8(malformed) n=%u\n", (unsigned int)(n) );
+	return( -2 );
+    }
+    for ( i=0; i<n; ++i ) {
+	if ( t[i].uni!=expect[i] || t[i].offset!=i ) {
+	    printf("error with uniNamesList_textUTF8(malformed) at %u\n", (unsigned int)(i) );
+	    return( -2 );
+	}
+    }
+    n=uniNamesList_textUTF16(bad16,6,t,16,&used);
+    if ( n!=5 || used!=6 || t[0].uni!=0x41 || t[1].uni!=0xFFFD || t[2].uni!=0xFFFD || \
+	 t[3].uni!=0x42 || t[4].uni!=0x1F600 || t[4].offset!=4 ) {
+	printf("error with uniNamesList_textUTF16()\n");
+	return( -3 );
+    }
+
+    /* text given in parts, split inside a sequence, gives no U+FFFD */
+    n=uniNamesList_textUTF8("x\xE2\x82",3,t,16,&used);
+    if ( n!=1 || used!=1 || t[0].uni!='x' || \
+	 (n=uniNamesList_textUTF8("\xE2\x82\xAC",3,t,16,&used))!=1 || used!=3 || t[0].uni!=0x20AC || \
+	 (n=uniNamesList_textUTF8("\xF0\x9F",2,t,16,&used))!=0 || used!=0 || \
+	 (n=uniNamesList_textUTF8("\xE2\x28",2,t,16,&used))!=2 || used!=2 || t[0].uni!=0xFFFD || \
+	 (n=uniNamesList_textUTF16(bad16+3,2,t,16,&used))!=1 || used!=1 || t[0].uni!=0x42 ) {
+	printf("error with uniNamesList_text*() split in a sequence\n");
+	return( -3 );
+    }
+    if ( uniNamesList_textUTF8Call("\xF4\x8F\xBF\xBF\xF4\x8F",6,text_keep,got)!=0 || \
+	 got[0]!=2 || got[1]!=0x10FFFF || got[2]!=0xFFFD ) {
+	printf("error with uniNamesList_textUTF8Call() cut at the end\n");
+	return( -3 );
+    }
+
+    /* encode every unicode value, then decode it all again */
+    if ( (buf=(unsigned char *)(malloc(0x110000*4)))==NULL || \
+	 (buf16=(uint16_t *)(malloc(0x110000*2*sizeof(uint16_t))))==NULL ) {
+	free(buf);
+	return( -4 );
+    }
+    for ( u=i=n=0; u<0x110000; ++u ) {
+	if ( u>=0xD800 && u<0xE000 ) continue;
+	if ( u<0x80 )
+	    buf[i++]=(unsigned char)(u);
+	else if ( u<0x800 ) {
+	    buf[i++]=(unsigned char)(0xC0|(u>>6));
+	    buf[i++]=(unsigned char)(0x80|(u&0x3F));
+	} else if ( u<0x10000 ) {
+	    buf[i++]=(unsigned char)(0xE0|(u>>12));
+	    buf[i++]=(unsigned char)(0x80|((u>>6)&0x3F));
+	    buf[i++]=(unsigned char)(0x80|(u&0x3F));
+	} else {
+	    buf[i++]=(unsigned char)(0xF0|(u>>18));
+	    buf[i++]=(unsigned char)(0x80|((u>>12)&0x3F));
+	    buf[i++]=(unsigned char)(0x80|((u>>6)&0x3F));
+	    buf[i++]=(unsigned char)(0x80|(u&0x3F));
+	}
+	if ( u<0x10000 )
+	    buf16[n++]=(uint16_t)(u);
+	else {
+	    buf16[n++]=(uint16_t)(0xD800+((u-0x10000)>>10));
+	    buf16[n++]=(uint16_t)(0xDC00+((u-0x10000)&0x3FF));
+	}
+    }
+    text_next=0;
+    if ( uniNamesList_textUTF8Call((const char *)(buf),i,text_check,NULL)!=0 || text_next!=0x110000 ) {
+	free(buf); free(buf16);
+	return( -5 );
+    }
+    text_next=0;
+    if ( uniNamesList_textUTF16Call(buf16,n,text_check,NULL)!=0 || text_next!=0x110000 ) {
+	free(buf); free(buf16);
+	return( -6 );
+    }
+    free(buf); free(buf16);
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST11
+static int test_namebuf(void) {
+    char buf[UNICODE_NAME_MAX+1];
+    const char *pt;
+    unsigned long u;
+    int len;
+
+    if ( uniNamesList_nameBuf(0x41,buf,5)!=22 || strcmp(buf,"LATI")!=0 || \
+	 uniNamesList_nameBuf(0x41,NULL,0)!=22 || \
+	 uniNamesList_nameBuf(0x300000,buf,sizeof(buf))!=-1 || buf[0]!='\0' || \
+	 uniNamesList_nameBuf(0,buf,sizeof(buf))!=-1 ) {
+	printf("error with uniNamesList_nameBuf(code,buf,size)\n");
+	return( -1 );
+    }
+
+    /* every name copied must be the same as uniNamesList_name() gives */
+    for ( u=0; u<0x110000; ++u ) {
+	len=uniNamesList_nameBuf(u,buf,sizeof(buf));
+	pt=uniNamesList_name(u);
+	if ( (pt==NULL && len!=-1) || (pt!=NULL && (len!=(int)(strlen(pt)) || !same(buf,pt))) ) {
+	    printf("error with uniNamesList_nameBuf(U+%04lX,buf,size)\n", u );
+	    return( -2 );
+	}
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST12
+static int test_ranges(void) {
+    uint32_t uni[4];
+    const char *names[4], *pt;
+    unsigned long u;
+    long n;
+
+    if ( test(0xAC00,uniNamesList_name(0xAC00),"HANGUL SYLLABLE GA") && \
+	 test(0xAC01,uniNamesList_name(0xAC01),"HANGUL SYLLABLE GAG") && \
+	 test(0xB098,uniNamesList_name(0xB098),"HANGUL SYLLABLE NA") && \
+	 test(0xD7A3,uniNamesList_name(0xD7A3),"HANGUL SYLLABLE HIH") && \
+	 test(0x4E00,uniNamesList_name(0x4E00),"CJK UNIFIED IDEOGRAPH-4E00") && \
+	 test(0x9FFF,uniNamesList_name(0x9FFF),"CJK UNIFIED IDEOGRAPH-9FFF") && \
+	 test(0x20000,uniNamesList_name(0x20000),"CJK UNIFIED IDEOGRAPH-20000") && \
+	 test(0x17000,uniNamesList_name(0x17000),"TANGUT IDEOGRAPH-17000") && \
+	 test(0x18D08,uniNamesList_name(0x18D08),"TANGUT IDEOGRAPH-18D08") && \
+	 test(0x2A6E0,uniNamesList_name(0x2A6E0),NULL) && \
+	 test(0xA000,uniNamesList_name(0xA000),"YI SYLLABLE IT") )
+	;
+    else {
+	printf("error with uniNamesList_name(code) for names made from code\n");
+	return( -1 );
+    }
+
+    if ( uniNamesList_codepoint("HANGUL SYLLABLE GA")==0xAC00 && \
+	 uniNamesList_codepoint("HANGUL SYLLABLE HIH")==0xD7A3 && \
+	 uniNamesList_codepoint("HANGUL SYLLABLE GGAG")==0xAE4D && \
+	 uniNamesList_codepoint("HANGUL SYLLABLE XYZ")==-1 && \
+	 uniNamesList_codepoint("CJK UNIFIED IDEOGRAPH-4E00")==0x4E00 && \
+	 uniNamesList_codepoint("CJK UNIFIED IDEOGRAPH-3134A")==0x3134A && \
+	 uniNamesList_codepoint("CJK UNIFIED IDEOGRAPH-04E00")==-1 && \
+	 uniNamesList_codepoint("CJK UNIFIED IDEOGRAPH-4e00")==-1 && \
+	 uniNamesList_codepoint("CJK UNIFIED IDEOGRAPH-2A6E0")==-1 && \
+	 uniNamesList_codepoint("TANGUT IDEOGRAPH-4E00")==-1 && \
+	 uniNamesList_codepointLen("TANGUT IDEOGRAPH-17000 ",22)==0x17000 )
+	;
+    else {
+	printf("error with uniNamesList_codepoint(name) for names made from code\n");
+	return( -2 );
+    }
+
+    /* all 11172 Hangul syllables have names, and go back to the same value */
+    for ( u=0xAC00, n=0; u<0xD7A4; ++u, ++n )
+	if ( uniNamesList_name(u)==NULL || uniNamesList_codepoint(uniNamesList_name(u))!=(long)(u) )
+    break;
+    if ( n!=11172 ) {
+	printf("error with Hangul syllable U+%04lX\n", u );
+	return( -3 );
+    }
+
+    /* a batch makes each name in its own place, and uniNamesList_name() */
+    /* uses another buffer */
+    uni[0] = 0xAC00; uni[1] = 0x41; uni[2] = 0x4E00; uni[3] = 0x17000;
+    if ( uniNamesList_nameBatch(uni,4,names)!=0 || (pt=uniNamesList_name(0x4E01))==NULL || \
+	 strcmp(pt,"CJK UNIFIED IDEOGRAPH-4E01")!=0 || strcmp(names[0],"HANGUL SYLLABLE GA")!=0 || \
+	 strcmp(names[1],"LATIN CAPITAL LETTER A")!=0 || strcmp(names[2],"CJK UNIFIED IDEOGRAPH-4E00")!=0 || \
+	 strcmp(names[3],"TANGUT IDEOGRAPH-17000")!=0 ) {
+	printf("error with names made from code in uniNamesList_nameBatch()\n");
+	return( -4 );
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST13
+struct found {
+    const char *query;
+    int flags;
+    unsigned long *uni;
+    size_t count, max;
+};
+
+/* Check name in a different way than the library does, ignoring case */
+static int found_match(const char *name, const char *query, int flags) {
+    char n[UNICODE_NAME_MAX+3], q[256], w[258];
+    size_t i, j;
+
+    n[0] = ' ';
+    for ( i=0; name[i]!='\0'; ++i ) n[i+1] = (char)(toupper((unsigned char)(name[i])));
+    n[i+1] = ' '; n[i+2] = '\0';
+    for ( i=0; query[i]!='\0' && i<255; ++i ) q[i] = (char)(toupper((unsigned char)(query[i])));
+    q[i] = '\0';
+    if ( flags==UN_SEARCH_PREFIX )
+	return( strncmp(n+1,q,strlen(q))==0 );
+    if ( flags==UN_SEARCH_SUBSTRING ) {
+	n[strlen(n)-1] = '\0';
+	return( strstr(n+1,q)!=NULL );
+    }
+    for ( i=0; q[i]!='\0'; i=j ) {
+	for ( ; q[i]==' '; ++i );
+	for ( j=i; q[j]!=' ' && q[j]!='\0'; ++j );
+	if ( j==i )
+    break;
+	sprintf(w," %.*s ",(int)(j-i),q+i);
+	if ( strstr(n,w)==NULL )
+	    return( 0 );
+    }
+    return( 1 );
+}
+
+static int found_add(unsigned long uni, const char *name, void *data) {
+    struct found *f = (struct found *)(data);
+
+    if ( f->count>=f->max || (f->count>0 && f->uni[f->count-1]>=uni) || \
+	 name==NULL || strcmp(name,uniNamesList_name(uni))!=0 || \
+	 !found_match(name,f->query,f->flags) ) {
+	printf("error with uniNamesList_search(\"%s\",%d) at U+%04lX\n", f->query, f->flags, uni );
+	return( -2 );
+    }
+    f->uni[f->count++] = uni;
+    return( 0 );
+}
+
+static int test_search(void) {
+    static const char *query[] = { "LATIN SMALL LETTER A", "latin small", "acute", "ARROW",
+	"HANGUL SYLLABLE GAG", "IDEOGRAPH-4E0", "syllable", "A", "DIGIT ZERO",
+	" SMALL LETTER", "TER A WI", "WITH  ACUTE", "QQQZZZ", "TANGUT IDEOGRAPH-1700", NULL };
+    struct found f;
+    const char *pt;
+    unsigned long u;
+    size_t i, k;
+    int flags, ret;
+
+    if ( (f.uni=(unsigned long *)(malloc(0x110000*sizeof(unsigned long))))==NULL )
+	return( -1 );
+    f.max = 0x110000;
+    for ( i=0; query[i]!=NULL; ++i ) for ( flags=UN_SEARCH_PREFIX; flags<=UN_SEARCH_WORDS; ++flags ) {
+	f.query = query[i]; f.flags = flags; f.count = 0;
+	if ( (ret=uniNamesList_search(query[i],flags,found_add,&f))!=0 ) {
+	    free(f.uni);
+	    return( ret );
+	}
+	/* check that no name was missed */
+	for ( u=k=0; u<0x110000; ++u ) if ( (pt=uniNamesList_name(u))!=NULL && found_match(pt,query[i],flags) ) {
+	    if ( k>=f.count || f.uni[k]!=u ) {
+		printf("error with uniNamesList_search(\"%s\",%d), U+%04lX missing\n", query[i], flags, u );
+		free(f.uni);
+		return( -3 );
+	    }
+	    ++k;
+	}
+	if ( k!=f.count ) {
+	    free(f.uni);
+	    return( -3 );
+	}
+	printf("uniNamesList_search(\"%s\",%d) found %lu names\n", query[i], flags, (unsigned long)(k) );
+    }
+    free(f.uni);
+
+    if ( uniNamesList_search(NULL,UN_SEARCH_PREFIX,found_first,&u)!=-1 || \
+	 uniNamesList_search("A",UN_SEARCH_PREFIX,NULL,&u)!=-1 || \
+	 uniNamesList_search("A",7,found_first,&u)!=-1 || \
+	 uniNamesList_search("  ",UN_SEARCH_SUBSTRING,found_first,&u)!=0 || \
+	 uniNamesList_search("latin capital letter a",UN_SEARCH_PREFIX,found_first,&u)!=1 || u!=0x41 || \
+	 uniNamesList_search("hangul syllable ga",UN_SEARCH_WORDS,found_first,&u)!=1 || u!=0xAC00 ) {
+	printf("error with uniNamesList_search(query,flags,fn,data)\n");
+	return( -4 );
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST14
+static int test_loose(void) {
+    char buf[UNICODE_NAME_MAX+1];
+    const char *pt;
+    unsigned long u;
+    size_t i;
+
+    if ( uniNamesList_codepointLoose("latin small letter a")==0x61 && \
+	 uniNamesList_codepointLoose("Latin_Small_Letter_A")==0x61 && \
+	 uniNamesList_codepointLoose("  LATINSMALL letter a ")==0x61 && \
+	 uniNamesList_codepointLoose("hyphen minus")==0x2D && \
+	 uniNamesList_codepointLoose("Hyphen-Minus")==0x2D && \
+	 uniNamesList_codepointLoose("tibetan letter -a")==0x0F60 && \
+	 uniNamesList_codepointLoose("tibetan letter a")==0x0F68 && \
+	 uniNamesList_codepointLoose("hangul jungseong o-e")==0x1180 && \
+	 uniNamesList_codepointLoose("hangul jungseong oe")==0x116C && \
+	 uniNamesList_codepointLoose("hangul jungseong o e")==0x116C && \
+	 uniNamesList_codepointLoose("cjk unified ideograph-4e00")==0x4E00 && \
+	 uniNamesList_codepointLoose("CJK unified ideograph 20000")==0x20000 && \
+	 uniNamesList_codepointLoose("hangul syllable gag")==0xAC01 && \
+	 uniNamesList_codepointLoose("latin small letter")==-1 && \
+	 uniNamesList_codepointLoose("latin small letter a-")==-1 && \
+	 uniNamesList_codepointLoose("")==-1 && \
+	 uniNamesList_codepointLoose(NULL)==-1 )
+	;
+    else {
+	printf("error with uniNamesList_codepointLoose(name)\n");
+	return( -1 );
+    }
+
+    /* every name, and every name in lower case with '_', is found */
+    for ( u=0; u<0x110000; ++u ) if ( (pt=uniNamesList_name(u))!=NULL ) {
+	for ( i=0; pt[i]!='\0'; ++i )
+	    buf[i] = pt[i]==' ' ? '_' : (char)(tolower((unsigned char)(pt[i])));
+	buf[i] = '\0';
+	if ( uniNamesList_codepointLoose(pt)!=(long)(u) || uniNamesList_codepointLoose(buf)!=(long)(u) ) {
+	    printf("error with uniNamesList_codepointLoose(\"%s\") for U+%04lX\n", buf, u );
+	    return( -2 );
+	}
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST15
+static int annot_line(unsigned long uni, int n, int kind, const char *name, const char *tag, int count, const uint32_t *seq) {
+    struct unicode_annotline line;
+    size_t pos=0;
+    int i;
+
+    for ( i=0; i<=n; ++i )
+	if ( uniNamesList_annotNext(uniNamesList_annot(uni),&pos,&line)!=1 )
+	    return( -1 );
+    if ( line.kind!=kind || line.count!=count || \
+	 (name==NULL ? line.name!=NULL : line.namelen!=strlen(name) || strncmp(line.name,name,line.namelen)!=0) || \
+	 (tag==NULL ? line.tag!=NULL : line.taglen!=strlen(tag) || strncmp(line.tag,tag,line.taglen)!=0) )
+	return( -1 );
+    for ( i=0; i<count; ++i )
+	if ( line.seq[i]!=seq[i] ) return( -1 );
+    return( 0 );
+}
+
+static int test_annotline(void) {
+    static const uint32_t s00A0[]={0xA0}, s5143[]={0x5143}, s03BC[]={0x3BC};
+    static const uint32_t s0418[]={0x418,0x306}, s00BD[]={0x31,0x2044,0x32};
+    static const uint32_t sFDFA[]={0x635,0x644,0x649,0x20,0x627,0x644,0x644,0x647,0x20,0x639,0x644,0x64A,0x647,0x20,0x648,0x633,0x644,0x645};
+    struct unicode_annotline line;
+    const char *annot;
+    unsigned long u;
+    size_t pos, prev;
+
+    if ( annot_line(0x20,2,'x',"no-break space",NULL,1,s00A0)==0 && \
+	 annot_line(0xA5,3,'x',NULL,NULL,1,s5143)==0 && \
+	 annot_line(0xA5,0,'=',NULL,NULL,0,NULL)==0 && \
+	 annot_line(0xB5,0,'#',"greek small letter mu",NULL,1,s03BC)==0 && \
+	 annot_line(0xBD,0,'#',NULL,"fraction",3,s00BD)==0 && \
+	 annot_line(0x419,0,':',NULL,NULL,2,s0418)==0 && \
+	 annot_line(0x418,0,'\t',NULL,NULL,0,NULL)==0 && \
+	 annot_line(0xFDFA,0,'#',NULL,"isolated",18,sFDFA)==0 )
+	;
+    else {
+	printf("error with uniNamesList_annotNext(annot,pos,line)\n");
+	return( -1 );
+    }
+    pos=0;
+    if ( uniNamesList_annotNext(NULL,&pos,&line)!=0 || uniNamesList_annotNext("",&pos,&line)!=0 || \
+	 uniNamesList_annotNext("\t* a",NULL,&line)!=-1 || uniNamesList_annotNext("\t* a",&pos,NULL)!=-1 ) {
+	printf("error with uniNamesList_annotNext() end or bad values\n");
+	return( -2 );
+    }
+
+    /* every line is returned in order, pointing inside the annotation */
+    for ( u=0; u<0x110000; ++u ) if ( (annot=uniNamesList_annot(u))!=NULL ) {
+	for ( pos=prev=0; uniNamesList_annotNext(annot,&pos,&line)==1; prev=pos ) {
+	    if ( line.text<annot+prev || line.text+line.len>annot+pos || \
+		 (annot[pos]!='\0' && line.text+line.len!=annot+pos-1) || \
+		 (line.kind=='\t' ? annot[prev+1]!='\t' : annot[prev+1]!=line.kind) || \
+		 (line.kind=='x' && line.count!=1) ) {
+		printf("error with uniNamesList_annotNext() for U+%04lX\n", u );
+		return( -3 );
+	    }
+	}
+	if ( annot[pos]!='\0' ) {
+	    printf("error with uniNamesList_annotNext() end for U+%04lX\n", u );
+	    return( -4 );
+	}
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST16
+static int test_xrefs(void) {
+    struct unicode_annotline line;
+    const uint32_t *out, *back;
+    unsigned long u, fcnt, bcnt;
+    size_t pos;
+    int i, j, n, nb;
+
+    if ( uniNamesList_xrefs(0x20,&out)!=9 || out[0]!=0xA0 || out[8]!=0xFEFF || \
+	 (nb=uniNamesList_xrefsBack(0xA0,&back))<1 || \
+	 uniNamesList_xrefs(0x41,&out)!=0 || out!=NULL || \
+	 uniNamesList_xrefs(0x110000,&out)!=-1 || uniNamesList_xrefs(0x20,NULL)!=-1 || \
+	 uniNamesList_xrefsAlt(0x20,0,&out)!=9 || uniNamesList_xrefsBackAlt(0xA0,0,&back)!=nb ) {
+	printf("error with uniNamesList_xrefs(uni,out)\n");
+	return( -1 );
+    }
+    for ( i=0; i<nb && back[i]!=0x20; ++i );
+    if ( i==nb ) {
+	printf("error with uniNamesList_xrefsBack(0xA0,out)\n");
+	return( -2 );
+    }
+
+    /* forward references are the x lines, and each has its back reference */
+    for ( u=fcnt=bcnt=0; u<0x110000; ++u ) {
+	n=uniNamesList_xrefs(u,&out);
+	for ( pos=0, j=0; uniNamesList_annotNext(uniNamesList_annot(u),&pos,&line)==1; ) {
+	    if ( line.kind!='x' || line.count!=1 ) continue;
+	    for ( i=0; i<j && out[i]!=line.seq[0]; ++i );
+	    if ( i<j ) continue;
+	    if ( j>=n || out[j]!=line.seq[0] ) break;
+	    ++j;
+	}
+	if ( n<0 || j!=n || (n==0 && out!=NULL) ) {
+	    printf("error with uniNamesList_xrefs() for U+%04lX\n", u );
+	    return( -3 );
+	}
+	for ( i=0; i<n; ++i ) {
+	    nb=uniNamesList_xrefsBack(out[i],&back);
+	    for ( j=0; j<nb && back[j]!=u; ++j );
+	    if ( j==nb ) {
+		printf("error with uniNamesList_xrefsBack() for U+%04lX\n", (unsigned long)(out[i]) );
+		return( -4 );
+	    }
+	}
+	fcnt+=(unsigned long)(n);
+	bcnt+=(unsigned long)(uniNamesList_xrefsBack(u,&back));
+    }
+    if ( fcnt!=bcnt ) {
+	printf("error with uniNamesList_xrefsBack() count\n");
+	return( -5 );
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST17
+static int test_display(void) {
+    static const char marks[]="*%x~:#";
+    static const char *symbols[6]={ "\xE2\x80\xA2", "\xE2\x80\xBB", "\xE2\x86\x92", "\xE2\x81\x93", "\xE2\x89\xA1", "\xE2\x89\x88" };
+    char buf[4*UNICODE_ANNOT_MAX];
+    const char *annot, *display, *m;
+    unsigned long u;
+    size_t i, k;
+
+    if ( (display=uniNamesList_annotDisplay(0xB6))==NULL || \
+	 strncmp(display,"\t= paragraph sign\n\t\xE2\x80\xA2 section sign",33)!=0 || \
+	 (display=uniNamesList_annotDisplay(0))==NULL || strcmp(display,"\t= NULL")!=0 || \
+	 uniNamesList_annotDisplay(0x41)!=NULL || uniNamesList_annotDisplay(0x110000)!=NULL || \
+	 (display=uniNamesList_annotDisplayAlt(0xB6,0))==NULL || strncmp(display,"\t= paragraph sign",17)!=0 ) {
+	printf("error with uniNamesList_annotDisplay(uni)\n");
+	return( -1 );
+    }
+#ifdef WANTANNOTDISPLAY
+    /* annotations without markup to replace are not kept twice */
+    if ( uniNamesList_annotDisplay(0)!=uniNamesList_annot(0) ) {
+	printf("error with uniNamesList_annotDisplay(0) sharing the annotation\n");
+	return( -2 );
+    }
+#endif
+
+    /* every annotation shows with the markup after each tab replaced */
+    for ( u=0; u<0x110000; ++u ) {
+	annot=uniNamesList_annot(u);
+	display=uniNamesList_annotDisplay(u);
+	if ( annot==NULL && display==NULL ) continue;
+	if ( annot==NULL || display==NULL ) break;
+	for ( i=k=0; annot[i]!='\0'; ++i ) {
+	    if ( annot[i]=='\t' && (i==0 || annot[i-1]=='\n') && annot[i+1]!='\0' && (m=strchr(marks,annot[i+1]))!=NULL ) {
+		buf[k++]='\t';
+		strcpy(buf+k,symbols[m-marks]);
+		k+=strlen(symbols[m-marks]);
+		++i;
+	    } else
+		buf[k++]=annot[i];
+	}
+	buf[k]='\0';
+	if ( strcmp(buf,display)!=0 ) break;
+    }
+    if ( u<0x110000 ) {
+	printf("error with uniNamesList_annotDisplay() for U+%04lX\n", u );
+	return( -3 );
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST18
+static int test_datafile(void) {
+    struct unicode_names *file;
+    const char *srcdir, *a, *b;
+    char path[1024], *buf, t;
+    FILE *fp;
+    unsigned long u;
+    long size, k;
+    uint32_t pool;
+    int i;
+
+    /* make check runs this in the build tree, nameslist.dat is in the source */
+    if ( (srcdir=getenv("srcdir"))==NULL ) srcdir=".";
+    if ( strlen(srcdir)+20>sizeof(path) ) return( -1 );
+    sprintf(path,"%s/../nameslist.dat",srcdir);
+    if ( uniNamesList_open(NULL)!=NULL || uniNamesList_open("call-test18.nofile")!=NULL || \
+	 (file=uniNamesList_open(path))==NULL ) {
+	printf("error with uniNamesList_open(%s)\n", path );
+	return( -1 );
+    }
+    if ( (a=uniNamesList_LanguageFile(file))==NULL || strcmp(a,"EN")!=0 || \
+	 (a=uniNamesList_NamesListVersionFile(file))==NULL || strcmp(a,uniNamesList_NamesListVersion())!=0 || \
+	 uniNamesList_LanguageFile(NULL)!=NULL || uniNamesList_nameFile(0x41,NULL)!=NULL ) {
+	printf("error with uniNamesList_LanguageFile() or uniNamesList_NamesListVersionFile()\n");
+	uniNamesList_close(file);
+	return( -2 );
+    }
+
+    /* the data file has the same names and annotations as the library */
+    for ( u=0; u<=0x110000; ++u ) {
+	a=uniNamesList_name(u); b=uniNamesList_nameFile(u,file);
+	if ( (a==NULL)!=(b==NULL) || (a!=NULL && strcmp(a,b)!=0) ) break;
+	if ( a!=NULL && uniNamesList_codepointFile(a,file)!=(long)(u) ) break;
+	a=uniNamesList_annot(u); b=uniNamesList_annotFile(u,file);
+	if ( (a==NULL)!=(b==NULL) || (a!=NULL && strcmp(a,b)!=0) ) break;
+	if ( uniNamesList_blockNumber(u)!=uniNamesList_blockNumberFile(u,file) ) break;
+    }
+    if ( u<=0x110000 || uniNamesList_blockCountFile(file)!=uniNamesList_blockCount() || \
+	 uniNamesList_codepointFile("NOT A NAME",file)!=-1 || uniNamesList_codepointFile("CJK UNIFIED IDEOGRAPH-41",file)!=-1 ) {
+	printf("error with uniNamesList_nameFile() or uniNamesList_annotFile() for U+%04lX\n", u );
+	uniNamesList_close(file);
+	return( -3 );
+    }
+    for ( i=0; i<uniNamesList_blockCount(); ++i )
+	if ( uniNamesList_blockStartFile(i,file)!=uniNamesList_blockStart(i) || \
+	     uniNamesList_blockEndFile(i,file)!=uniNamesList_blockEnd(i) || \
+	     (a=uniNamesList_blockNameFile(i,file))==NULL || strcmp(a,uniNamesList_blockName(i))!=0 ) {
+	    printf("error with uniNamesList_block...File(%d)\n", i );
+	    uniNamesList_close(file);
+	    return( -4 );
+	}
+    if ( uniNamesList_blockNameFile(i,file)!=NULL || uniNamesList_blockStartFile(-1,file)!=-1 ) {
+	printf("error with uniNamesList_block...File() for bad blocks\n");
+	uniNamesList_close(file);
+	return( -4 );
+    }
+    uniNamesList_close(file);
+
+    /* a file that was cut short is not opened */
+    if ( (fp=fopen(path,"rb"))==NULL || fseek(fp,0,SEEK_END)!=0 || (size=ftell(fp))<=0 || \
+	 (buf=(char *)(malloc((size_t)(size))))==NULL ) {
+	if ( fp!=NULL ) fclose(fp);
+	return( -5 );
+    }
+    if ( fseek(fp,0,SEEK_SET)!=0 || fread(buf,1,(size_t)(size),fp)!=(size_t)(size) ) {
+	free(buf); fclose(fp);
+	return( -5 );
+    }
+    fclose(fp);
+    if ( (fp=fopen("call-test18.dat","wb"))==NULL || fwrite(buf,1,(size_t)(size/2),fp)!=(size_t)(size/2) ) {
+	if ( fp!=NULL ) fclose(fp);
+	free(buf);
+	return( -5 );
+    }
+    fclose(fp);
+    file=uniNamesList_open("call-test18.dat");
+    remove("call-test18.dat");
+    if ( file!=NULL ) {
+	printf("error with uniNamesList_open() of a short file\n");
+	uniNamesList_close(file);
+	free(buf);
+	return( -6 );
+    }
+
+    /* the file is little-endian, one made big-endian is swapped when opened */
+    pool=(uint32_t)((unsigned char)(buf[28]))|(uint32_t)((unsigned char)(buf[29]))<<8| \
+	 (uint32_t)((unsigned char)(buf[30]))<<16|(uint32_t)((unsigned char)(buf[31]))<<24;
+    for ( k=8; k<(long)(pool) && k+3<size; k+=4 ) {
+	t=buf[k]; buf[k]=buf[k+3]; buf[k+3]=t;
+	t=buf[k+1]; buf[k+1]=buf[k+2]; buf[k+2]=t;
+    }
+    if ( (fp=fopen("call-test18.dat","wb"))==NULL || fwrite(buf,1,(size_t)(size),fp)!=(size_t)(size) ) {
+	if ( fp!=NULL ) fclose(fp);
+	remove("call-test18.dat");
+	free(buf);
+	return( -7 );
+    }
+    fclose(fp); free(buf);
+    file=uniNamesList_open("call-test18.dat");
+    remove("call-test18.dat");
+    for ( u=0; file!=NULL && u<0x30000; ++u ) {
+	a=uniNamesList_name(u); b=uniNamesList_nameFile(u,file);
+	if ( (a==NULL)!=(b==NULL) || (a!=NULL && strcmp(a,b)!=0) ) break;
+	a=uniNamesList_annot(u); b=uniNamesList_annotFile(u,file);
+	if ( (a==NULL)!=(b==NULL) || (a!=NULL && strcmp(a,b)!=0) ) break;
+	if ( uniNamesList_blockNumber(u)!=uniNamesList_blockNumberFile(u,file) ) break;
+    }
+    if ( file==NULL || u<0x30000 || uniNamesList_blockCountFile(file)!=uniNamesList_blockCount() || \
+	 uniNamesList_codepointFile(uniNamesList_name(0x41),file)!=0x41 || \
+	 uniNamesList_codepointFile(uniNamesList_name(0xAC00),file)!=0xAC00 ) {
+	printf("error with uniNamesList_open() of a big-endian file for U+%04lX\n", u );
+	uniNamesList_close(file);
+	return( -7 );
+    }
+    uniNamesList_close(file);
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST19
+static int test_langload(void) {
+    const char *pt;
+#ifdef HAVE_DLOPEN
+    void *h;
+
+    /* English lookups do not load libuninameslist-fr */
+    if ( uniNamesList_name(0x41)==NULL || uniNamesList_nameAlt(0x41,0)==NULL || \
+	 uniNamesList_Languages(0)==NULL || (h=dlopen(UN_FR_DLNAME,RTLD_LAZY|RTLD_NOLOAD))!=NULL ) {
+	printf("error, %s was loaded before it was used\n", UN_FR_DLNAME );
+	return( -1 );
+    }
+#endif
+    if ( (pt=uniNamesList_Languages(1))==NULL || strcmp(pt,"FR")!=0 || uniNamesList_Languages(2)!=NULL || \
+	 (pt=uniNamesList_NamesListVersionAlt(1))==NULL || strcmp(pt,NFR_VERSION)!=0 || \
+	 uniNamesList_NamesListVersionAlt(2)!=NULL || (pt=uniNamesList_nameAlt(0x41,1))==NULL || \
+	 strcmp(pt,"LATIN CAPITAL LETTER A")==0 || (pt=uniNamesList_nameAlt(0x41,2))==NULL || \
+	 strcmp(pt,"LATIN CAPITAL LETTER A")!=0 ) {
+	printf("error with the French language pack\n");
+	return( -2 );
+    }
+#ifdef HAVE_DLOPEN
+    /* it is loaded now, and stays loaded */
+    if ( (h=dlopen(UN_FR_DLNAME,RTLD_LAZY|RTLD_NOLOAD))==NULL ) {
+	printf("error, %s was not loaded by uniNamesList_Languages(1)\n", UN_FR_DLNAME );
+	return( -3 );
+    }
+    dlclose(h);
+#endif
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST20
+static int test_nextnamed(void) {
+    long u, v, n;
+    int b;
+
+    /* going through all values finds the same ones as uniNamesList_name() */
+    for ( u=0, v=uniNamesList_nextNamed(0), n=0; u<0x110000; ++u ) {
+	if ( uniNamesList_name((unsigned long)(u))==NULL )
+    continue;
+	if ( v!=u ) {
+	    printf("error, uniNamesList_nextNamed() gave %lX not U+%04lX\n", v, u );
+	    return( -1 );
+	}
+	if ( uniNamesList_nextNamed((unsigned long)(u))!=u || uniNamesList_nextNamedAlt((unsigned long)(u),0)!=u ) {
+	    printf("error, uniNamesList_nextNamed(U+%04lX) did not return it\n", u );
+	    return( -1 );
+	}
+	v=uniNamesList_nextNamed((unsigned long)(u+1));
+	++n;
+    }
+    if ( v!=-1 || n==0 || uniNamesList_nextNamed(0x110000)!=-1 || uniNamesList_nextNamed(0xFFFFFFFFUL)!=-1 ) {
+	printf("error, uniNamesList_nextNamed() past the last name\n");
+	return( -2 );
+    }
+    if ( uniNamesList_nextNamed(0)!=0x20 || uniNamesList_nextNamed(0xE000)!=0xF900 || \
+	 uniNamesList_nextNamed(0x4E00)!=0x4E00 || uniNamesList_nextNamed(0xAC01)!=0xAC01 ) {
+	printf("error with uniNamesList_nextNamed() at U+0000, U+E000, U+4E00 or U+AC01\n");
+	return( -2 );
+    }
+
+    /* blocks and planes only give their own names */
+    for ( b=0; b<uniNamesList_blockCount(); ++b ) {
+	u=uniNamesList_blockStart(b)-1;
+	while ( (u=uniNamesList_nextNamed((unsigned long)(u+1)))>=0 && u<=uniNamesList_blockEnd(b) )
+	    if ( uniNamesList_nextNamedBlock((unsigned long)(u),b)!=u ) {
+		printf("error, uniNamesList_nextNamedBlock() missed U+%04lX in block %d\n", u, b );
+		return( -3 );
+	    }
+	if ( (v=uniNamesList_nextNamed((unsigned long)(uniNamesList_blockStart(b))))>uniNamesList_blockEnd(b) )
+	    v=-1;
+	if ( uniNamesList_nextNamedBlock(0,b)!=v || \
+	     uniNamesList_nextNamedBlock((unsigned long)(uniNamesList_blockEnd(b)+1),b)!=-1 ) {
+	    printf("error, uniNamesList_nextNamedBlock() outside of block %d\n", b );
+	    return( -3 );
+	}
+    }
+    if ( uniNamesList_nextNamedBlock(0,-1)!=-1 || uniNamesList_nextNamedBlock(0,b)!=-1 ) {
+	printf("error, uniNamesList_nextNamedBlock() of a bad block\n");
+	return( -3 );
+    }
+    for ( b=0; b<=16; ++b ) {
+	u=uniNamesList_nextNamed((unsigned long)(b)<<16);
+	v=uniNamesList_nextNamedPlane(0,(unsigned int)(b));
+	if ( (u>=0 && (u>>16)==b ? v!=u : v!=-1) || uniNamesList_nextNamedPlane(((unsigned long)(b)<<16)+0x10000,(unsigned int)(b))!=-1 ) {
+	    printf("error with uniNamesList_nextNamedPlane(%d)\n", b );
+	    return( -4 );
+	}
+    }
+    if ( uniNamesList_nextNamedPlane(0,17)!=-1 || uniNamesList_nextNamedPlane(0x1FFFF,1)!=-1 || \
+	 uniNamesList_nextNamedPlane(0x10000,0)!=-1 || uniNamesList_nextNamedPlane(0x10000,1)!=0x10000 ) {
+	printf("error with uniNamesList_nextNamedPlane() at plane ends\n");
+	return( -4 );
+    }
+    return( 0 );
+}
+#endif
+
+#ifdef DO_CALL_TEST21
+static int search_count(unsigned long uni, const char *name, void *data) {
+    (void)(uni); (void)(name);
+    ++*(unsigned long *)(data);
+    return( 0 );
+}
+
+static int test_searchhex(void) {
+    static const char *query[] = { "4E0", "F9", "1", "2A6D", "e8", "17000", NULL };
+    char buf[UN_NAMESIZE], q[8];
+    const char *pt;
+    unsigned long u, want, total, found;
+    size_t i, k;
+
+    for ( i=0; query[i]!=NULL; ++i ) {
+	for ( k=0; query[i][k]!='\0'; ++k ) q[k] = (char)(toupper((unsigned char)(query[i][k])));
+	q[k] = '\0';
+	/* made names that have q in them, and all names that have it */
+	for ( u=want=total=0; u<0x110000; ++u ) {
+	    if ( unicode_rangename(u,buf)!=NULL && strstr(buf,q)!=NULL ) ++want;
+	    if ( (pt=uniNamesList_name(u))!=NULL && strstr(pt,q)!=NULL ) ++total;
+	}
+	range_visits = found = 0;
+	if ( uniNamesList_search(query[i],UN_SEARCH_SUBSTRING,search_count,&found)!=0 || \
+	     found!=total || range_visits!=want ) {
+	    printf("error with uniNamesList_search(\"%s\") found %lu of %lu, made %lu names for %lu\n",
+		   query[i], found, total, range_visits, want );
+	    return( -1 );
+	}
+	printf("uniNamesList_search(\"%s\") made %lu names, found %lu\n", query[i], range_visits, found );
+    }
+    return( 0 );
+}
+#endif
+
 int main(int argc, char **argv) {
     int ret;
 
@@ -448,6 +1397,62 @@ int main(int argc, char **argv) {
 #ifdef DO_CALL_TEST7
     /* English and French libraries. Substitute test. */
     ret=test_calls_07();
+#endif
+#ifdef DO_CALL_TEST8
+    /* reverse lookup, character name to unicode value */
+    ret=test_codepoint();
+#endif
+#ifdef DO_CALL_TEST9
+    /* batch lookups must agree with single lookups */
+    ret=test_batch();
+#endif
+#ifdef DO_CALL_TEST10
+    /* decode UTF-8 and UTF-16 text and look up each character */
+    ret=test_text();
+#endif
+#ifdef DO_CALL_TEST11
+    /* copy names into a buffer given by the caller */
+    ret=test_namebuf();
+#endif
+#ifdef DO_CALL_TEST12
+    /* names made from the code, Hangul, CJK and Tangut */
+    ret=test_ranges();
+#endif
+#ifdef DO_CALL_TEST13
+    /* search names by prefix, substring or words */
+    ret=test_search();
+#endif
+#ifdef DO_CALL_TEST14
+    /* reverse lookup with loose matching of names */
+    ret=test_loose();
+#endif
+#ifdef DO_CALL_TEST15
+    /* parse annotation lines without copying them */
+    ret=test_annotline();
+#endif
+#ifdef DO_CALL_TEST16
+    /* x cross-references both ways, made by buildnameslist */
+    ret=test_xrefs();
+#endif
+#ifdef DO_CALL_TEST17
+    /* annotations with the markup replaced by symbols */
+    ret=test_display();
+#endif
+#ifdef DO_CALL_TEST18
+    /* names, annotations and blocks from the data file */
+    ret=test_datafile();
+#endif
+#ifdef DO_CALL_TEST19
+    /* French is loaded on first use, not with the English library */
+    ret=test_langload();
+#endif
+#ifdef DO_CALL_TEST20
+    /* go through named values, skipping empty pages and planes */
+    ret=test_nextnamed();
+#endif
+#ifdef DO_CALL_TEST21
+    /* substring search of hex digits only makes the names that match */
+    ret=test_searchhex();
 #endif
     return ret;
 }
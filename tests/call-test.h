@@ -0,0 +1,2 @@
+const char NL_VERSION[] = "Nameslist-Version: 14.0";
+const char NFR_VERSION[] = "Nameslist-Version: 14.0";
@@ -0,0 +1,2 @@
+#define DO_CALL_TEST11 1
+#include "call-test.c"
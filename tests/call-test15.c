@@ -0,0 +1,2 @@
+#define DO_CALL_TEST15 1
+#include "call-test.c"
@@ -3,6 +3,9 @@
 
 /* This file was generated using the program 'buildnameslist.c' */
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -16,6 +19,33 @@ struct unicode_block {
 struct unicode_nameannot {
 	const char *name, *annot;
 };
+
+struct unicode_text {
+	size_t offset;
+	uint32_t uni;
+	int block;
+	const char *name;
+};
+
+/* uniNamesList_search() finds names that start with query, that have */
+/* query in them, or that have all the words of query in any order. */
+#define UN_SEARCH_PREFIX	0
+#define UN_SEARCH_SUBSTRING	1
+#define UN_SEARCH_WORDS		2
+
+/* One line of an annotation, see uniNamesList_annotNext(). kind is the */
+/* markup character below, or a tab for a comment continued on a line. */
+/* text is the line after the markup (not '\0' ended). seq[] has count */
+/* codes: the x cross-reference, or the : # ~ sequence. name is the x */
+/* name or the text after the sequence, and tag is the # <tag> if any. */
+/* UN_ANNOT_SEQ_MAX is the longest decomposition, of U+FDFA. */
+#define UN_ANNOT_SEQ_MAX	18
+struct unicode_annotline {
+	const char *text, *name, *tag;
+	size_t len, namelen, taglen;
+	int kind, count;
+	uint32_t seq[UN_ANNOT_SEQ_MAX];
+};
 #endif
 
 /* NOTE: Build your program to access the functions if using multilanguage. */
@@ -28,6 +58,8 @@ extern const struct unicode_block UnicodeBlockFR[334];
 /* but can change for later versions of NamesList (use as an example guide) */
 #define UNICODE_FR_NAME_MAX	100
 #define UNICODE_FR_ANNOT_MAX	748
+
+/* Only available if built using './configure --enable-nameannot' */
 extern const struct unicode_nameannot * const *const UnicodeNameAnnotFR[];
 
 /* Index by: UnicodeNameAnnotFR[(uni>>16)&0x1f][(uni>>8)&0xff][uni&0xff] */
@@ -42,7 +74,11 @@ extern const struct unicode_nameannot * const *const UnicodeNameAnnotFR[];
 /*  = should remain itself */
 
 /* Return a pointer to the name for this unicode value */
-/* This value points to a constant string inside the library */
+/* This value points to a constant string inside the library, except */
+/* names made from the unicode value (Hangul syllables, CJK and Tangut */
+/* ideographs), or all names if built using './configure --enable-nametokens'. */
+/* These are made in a buffer for this thread, which is valid until the */
+/* next uniNamesList_name() on it. Use uniNamesList_nameBuf() to keep one. */
 const char *uniNamesList_nameFR(unsigned long uni);
 
 /* Returns pointer to the annotations for this unicode value */
@@ -57,8 +93,8 @@ const char *uniNamesList_NamesListVersionFR(void);
 /* These functions are available in libuninameslist-0.4.20140731 and higher */
 
 /* Version information for this <uninameslist.h> include file */
-#define LIBUNINAMESLIST_FR_MAJOR	1
-#define LIBUNINAMESLIST_FR_MINOR	5
+#define LIBUNINAMESLIST_FR_MAJOR	2
+#define LIBUNINAMESLIST_FR_MINOR	0
 
 /* Return number of blocks in this NamesList (Version 14.0). */
 int uniNamesList_blockCountFR(void);
@@ -97,6 +133,77 @@ int uniNamesList_names2lnUFR(unsigned long uni);
 const char *uniNamesList_names2anCFR(int count);
 const char *uniNamesList_names2anUFR(unsigned long uni);
 
+/* These functions are available in libuninameslist-20261017 and higher */
+
+/* Return unicode value for this character name. Return -1 if not found. */
+/* Names must match exactly, len is the number of name characters used. */
+long uniNamesList_codepointFR(const char *name);
+long uniNamesList_codepointLenFR(const char *name, size_t len);
+
+/* Same using the loose matching rule UAX44-LM2, which ignores case, */
+/* spaces, '_' and medial hyphens, like "latin small letter a". */
+long uniNamesList_codepointLooseFR(const char *name);
+
+/* Copy name into buf, cut to size-1 characters. Return name length, */
+/* like snprintf(), or -1 if there is no name for this unicode value. */
+int uniNamesList_nameBufFR(unsigned long uni, char *buf, size_t size);
+
+/* Fill names[]/annots[]/blocks[] for count unicode values (0=ok, -1=error). */
+/* Bad unicode values give NULL pointers or block number -1, as above. */
+/* Names that are made, as for uniNamesList_name(), are put in a buffer for */
+/* this thread, valid until the next ...Batch() or text...() call on it. */
+/* It grows to hold the names made by one call, and is not freed. */
+/* nameBatch() gives -1, with NULL for these, if there is no memory. */
+int uniNamesList_nameBatchFR(const uint32_t *uni, size_t count, const char **names);
+int uniNamesList_annotBatchFR(const uint32_t *uni, size_t count, const char **annots);
+int uniNamesList_blockNumberBatchFR(const uint32_t *uni, size_t count, int *blocks);
+
+/* Decode UTF-8 (or UTF-16) text, and return the offset, unicode value, */
+/* block number and name of each character. Malformed input is U+FFFD. */
+/* Fill up to max out[], return count filled, and *used=units consumed. */
+/* A sequence (or surrogate pair) cut at the end of buf is not consumed, */
+/* so if *used<len, pass the rest again with the next part of the text. */
+/* At the end of the text, what is left is malformed (U+FFFD). Names are */
+/* valid as for ...Batch(), and NULL if there is no memory to make them. */
+size_t uniNamesList_textUTF8FR(const char *buf, size_t len, struct unicode_text *out, size_t max, size_t *used);
+size_t uniNamesList_textUTF16FR(const uint16_t *buf, size_t len, struct unicode_text *out, size_t max, size_t *used);
+
+/* Call fn() for each character of buf, which is all of the text, so a */
+/* sequence cut at its end is U+FFFD. Return 0 when done, -1 if error, */
+/* or else the non-zero value that fn() returned to stop early. t->name */
+/* is only valid until fn() returns. */
+int uniNamesList_textUTF8CallFR(const char *buf, size_t len, int (*fn)(const struct unicode_text *t, void *data), void *data);
+int uniNamesList_textUTF16CallFR(const uint16_t *buf, size_t len, int (*fn)(const struct unicode_text *t, void *data), void *data);
+
+/* Call fn() in unicode order for each name found by query, using flags */
+/* UN_SEARCH_PREFIX, UN_SEARCH_SUBSTRING or UN_SEARCH_WORDS. ASCII case is */
+/* ignored. name is only valid until fn() returns. Return 0 when done, */
+/* -1 if error, or else the non-zero value that fn() returned to stop. */
+int uniNamesList_searchFR(const char *query, int flags, int (*fn)(unsigned long uni, const char *name, void *data), void *data);
+
+/* Parse the annotation lines without copying, starting with *pos=0. */
+/* Return 1 and fill line, 0 at the end of annot (or NULL), or -1 if error. */
+int uniNamesList_annotNextFR(const char *annot, size_t *pos, struct unicode_annotline *line);
+
+/* Return count of unicode values in the x cross-references of this one, */
+/* or that have it in their x cross-references with ...Back(), and point */
+/* *out to them inside the library, or NULL if none. -1 if bad unicode value. */
+int uniNamesList_xrefsFR(unsigned long uni, const uint32_t **out);
+int uniNamesList_xrefsBackFR(unsigned long uni, const uint32_t **out);
+
+/* Return the annotations with the markup above replaced by the symbols, */
+/* in UTF-8. These are kept in the library if built using './configure */
+/* --enable-annotdisplay', else made in a buffer for this thread, which the */
+/* next call reuses. */
+const char *uniNamesList_annotDisplayFR(unsigned long uni);
+
+/* Return the first unicode value from uni on that has a name, or -1 if */
+/* none. ...Block() and ...Plane() only look in that block or plane. To */
+/* go through them all use: for ( u=..(0); u>=0; u=..(u+1) ) */
+long uniNamesList_nextNamedFR(unsigned long uni);
+long uniNamesList_nextNamedBlockFR(unsigned long uni, int uniBlock);
+long uniNamesList_nextNamedPlaneFR(unsigned long uni, unsigned int plane);
+
 #ifdef __cplusplus
 }
 #endif